@@ -0,0 +1,118 @@
+// ================== bootstrap/BytecodeCache.cpp ==================
+#include "bootstrap/BytecodeCache.h"
+#include "core/logging/Logging.h"
+
+#include "luacode.h"
+#include "Luau/Bytecode.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+// ---------------- Key ----------------
+
+static constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ull;
+static constexpr uint64_t kFnvPrime  = 0x100000001b3ull;
+
+static void HashBytes(uint64_t& h, const void* data, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= kFnvPrime;
+    }
+}
+
+static void HashInt(uint64_t& h, int v) { HashBytes(h, &v, sizeof(v)); }
+
+static void HashStr(uint64_t& h, const char* s) {
+    // the terminator is hashed too, so ("ab","c") and ("a","bc") differ
+    if (s) HashBytes(h, s, std::char_traits<char>::length(s) + 1);
+    else   HashInt(h, -1);
+}
+
+static void HashList(uint64_t& h, const char* const* list) {
+    if (list) for (; *list; ++list) HashStr(h, *list);
+    HashInt(h, -1);
+}
+
+BytecodeCache::Key BytecodeCache::MakeKey(const std::string& source, const lua_CompileOptions& opts) {
+    uint64_t h = kFnvOffset;
+    HashInt(h, LBC_VERSION_MAX);
+    HashInt(h, LBC_TYPE_VERSION_MAX);
+    HashInt(h, opts.optimizationLevel);
+    HashInt(h, opts.debugLevel);
+    HashInt(h, opts.typeInfoLevel);
+    HashInt(h, opts.coverageLevel);
+    HashStr(h, opts.vectorLib);
+    HashStr(h, opts.vectorCtor);
+    HashStr(h, opts.vectorType);
+    HashList(h, opts.mutableGlobals);
+    HashList(h, opts.userdataTypes);
+    HashList(h, opts.librariesWithKnownMembers);
+    HashList(h, opts.disabledBuiltins);
+    HashBytes(h, source.data(), source.size());
+    return h;
+}
+
+// ---------------- Lookup ----------------
+
+void BytecodeCache::SetDirectory(const std::string& dir) {
+    directory = dir;
+    if (directory.empty()) return;
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        LOGW("BytecodeCache: cannot create '%s' (%s); disk cache off", directory.c_str(), ec.message().c_str());
+        directory.clear();
+    }
+}
+
+std::string BytecodeCache::PathFor(Key key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.luauc", (unsigned long long)key);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+const std::string* BytecodeCache::Find(Key key) {
+    auto it = entries.find(key);
+    if (it != entries.end()) { hits++; return &it->second; }
+
+    if (!directory.empty()) {
+        std::ifstream in(PathFor(key), std::ios::binary);
+        if (in.is_open()) {
+            std::string bytecode((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            // a truncated write or a different Luau leaves a file luau_load would reject
+            if (!bytecode.empty() && (uint8_t)bytecode[0] >= LBC_VERSION_MIN && (uint8_t)bytecode[0] <= LBC_VERSION_MAX) {
+                diskHits++;
+                return &entries.emplace(key, std::move(bytecode)).first->second;
+            }
+        }
+    }
+
+    misses++;
+    return nullptr;
+}
+
+const std::string& BytecodeCache::Store(Key key, std::string bytecode) {
+    const std::string& stored = entries.insert_or_assign(key, std::move(bytecode)).first->second;
+
+    // compile errors (version byte 0) stay in memory only
+    if (!directory.empty() && !stored.empty() && stored[0] != 0) {
+        const std::string path = PathFor(key);
+        const std::string tmp  = path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) return stored;
+            out.write(stored.data(), (std::streamsize)stored.size());
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec);
+        if (ec) {
+            LOGW("BytecodeCache: cannot write '%s' (%s)", path.c_str(), ec.message().c_str());
+            std::filesystem::remove(tmp, ec);
+        }
+    }
+    return stored;
+}
@@ -0,0 +1,36 @@
+// ================== bootstrap/BytecodeCache.h ==================
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+struct lua_CompileOptions;
+
+// Compiled Luau bytecode keyed by a hash of the source text and the compile
+// options that shaped it. Lookups hit memory first, then the on-disk level
+// (one file per key under the cache directory) when a directory is set.
+class BytecodeCache {
+public:
+    using Key = uint64_t;
+
+    static Key MakeKey(const std::string& source, const lua_CompileOptions& opts);
+
+    // Empty disables the disk level
+    void SetDirectory(const std::string& dir);
+    const std::string& Directory() const { return directory; }
+
+    // nullptr on a miss at both levels
+    const std::string* Find(Key key);
+    // Keeps 'bytecode' and writes it through to disk; returns the stored copy
+    const std::string& Store(Key key, std::string bytecode);
+
+    size_t hits = 0;
+    size_t diskHits = 0;
+    size_t misses = 0;
+
+private:
+    std::string PathFor(Key key) const;
+
+    std::unordered_map<Key, std::string> entries;
+    std::string directory;
+};
@@ -1,7 +1,9 @@
 #include "Game.h"
 #include "ScriptingAPI.h"
+#include "LuaAtoms.h"
 #include "bootstrap/instances/InstanceTypes.h"
 #include "bootstrap/services/Service.h"
+#include "bootstrap/services/RunService.h"
 #include "lua.h"
 #include "lualib.h"
 #include "luacode.h"
@@ -19,43 +21,51 @@ Game::Game(std::string name)
 
 Game::~Game() = default;
 
+// Engine API plus the game globals, for the game's VM and every Actor's
+static void SetupLuaState(Game* game, lua_State* L) {
+    RegisterSharedLibreboxAPI(L);
+
+    // expose global "game"
+    Lua_PushInstance(L, game->shared_from_this());
+    lua_setglobal(L, "game");
+
+    // expose Workspace global
+    if (game->workspace) {
+        Lua_PushInstance(L, game->workspace);
+        lua_setglobal(L, "Workspace");
+    }
+}
+
 void Game::Init() {
     LOGI("Game::Init begin");
 
     // Lua scheduler
     luaScheduler = std::make_unique<LuaScheduler>();
-    if (luaScheduler && luaScheduler->GetMainState()) {
-        RegisterSharedLibreboxAPI(luaScheduler->GetMainState());
-    }
-
-    // expose global "game"
-    auto* L = luaScheduler ? luaScheduler->GetMainState() : nullptr;
-    if (L) {
-        Lua_PushInstance(L, shared_from_this());
-        lua_setglobal(L, "game");
-    }
 
     // --- Precreate core services under 'game'
-    const char* defaults[] = { "Workspace", "RunService", "Lighting" };
+    const char* defaults[] = { "Workspace", "RunService", "Lighting", "CollectionService" };
     for (const char* n : defaults) {
         Service::Create(n);
     }
 
+    // RunService events exist before any script runs; actors read them in
+    // parallel, where creating them would race
+    if (auto rs = std::dynamic_pointer_cast<RunService>(Service::Get("RunService"))) rs->EnsureSignals();
+
     // cache Workspace pointer
     workspace = std::dynamic_pointer_cast<Workspace>(Service::Get("Workspace"));
 
     // create camera inside Workspace if missing
     if (workspace && !workspace->camera) {
-        workspace->camera = std::make_shared<CameraGame>("Camera");
+        workspace->camera = Instance::Make<CameraGame>("Camera");
         workspace->camera->SetParent(workspace);
         workspace->camera->SetName("CurrentCamera");
     }
 
-    // expose Workspace global
-    if (L && workspace) {
-        Lua_PushInstance(L, workspace);
-        lua_setglobal(L, "Workspace");
+    if (luaScheduler->GetMainState()) {
+        SetupLuaState(this, luaScheduler->GetMainState());
     }
+    luaScheduler->SetStateSetup([this](lua_State* L) { SetupLuaState(this, L); });
 
     LOGI("Game::Init done");
 }
@@ -71,14 +81,9 @@ void Game::Shutdown() {
     LOGI("Game::Shutdown end");
 }
 
-static std::shared_ptr<Instance>* checkInstanceUD(lua_State* L, int idx) {
-    return static_cast<std::shared_ptr<Instance>*>(
-        luaL_checkudata(L, idx, "Librebox.Instance"));
-}
-
 // game:GetService(name)
 static int l_game_getservice(lua_State* L) {
-    auto* inst_ptr = checkInstanceUD(L, 1);
+    auto* inst_ptr = Lua_CheckInstance(L, 1);
     if (!inst_ptr || !*inst_ptr) { luaL_error(L, "GetService: invalid self"); return 0; }
     const char* name = luaL_checkstring(L, 2);
     auto svc = Service::Get(name);
@@ -89,15 +94,17 @@ static int l_game_getservice(lua_State* L) {
 
 // game:FindService(name) -> may return nil
 static int l_game_findservice(lua_State* L) {
-    auto* inst_ptr = checkInstanceUD(L, 1);
+    auto* inst_ptr = Lua_CheckInstance(L, 1);
     if (!inst_ptr || !*inst_ptr) { lua_pushnil(L); return 1; }
     const char* name = luaL_checkstring(L, 2);
     Lua_PushInstance(L, Service::Get(name));
     return 1;
 }
 
-bool Game::LuaGet(lua_State* L, const char* key) const {
-    if (std::strcmp(key, "GetService") == 0) { lua_pushcfunction(L, l_game_getservice, "GetService"); return true; }
-    if (std::strcmp(key, "FindService") == 0){ lua_pushcfunction(L, l_game_findservice,"FindService"); return true; }
-    return false;
+bool Game::LuaGet(lua_State* L, int atom) const {
+    switch (atom) {
+    case Atom_GetService:  lua_pushcfunction(L, l_game_getservice, "GetService"); return true;
+    case Atom_FindService: lua_pushcfunction(L, l_game_findservice,"FindService"); return true;
+    default: return Instance::LuaGet(L, atom);
+    }
 }
\ No newline at end of file
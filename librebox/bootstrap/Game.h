@@ -19,7 +19,7 @@ public:
     void Init();
     void Shutdown();
 
-    bool LuaGet(lua_State* L, const char* key) const override;
+    bool LuaGet(lua_State* L, int atom) const override;
 };
 
 // Global
@@ -1,11 +1,92 @@
 #include "bootstrap/Instance.h"
+#include "bootstrap/Reflection.h"
 #include "core/logging/Logging.h"
 #include <algorithm>
+#include <map>
 #include <unordered_map>
+#include <unordered_set>
+
+// -------- class/tag indices --------
+// DataModel members by concrete class and by tag. A subtree joins when it is
+// parented under the DataModel and leaves when it is detached, in the same
+// attachChild/detachChild that update Children, so queries never walk the tree.
+namespace {
+struct TagEvent {
+    std::shared_ptr<Instance> inst;
+    std::string tag;
+    bool added;
+};
+struct MembershipIndex {
+    std::vector<Instance*> byClass[kInstanceClassCount];
+    std::unordered_map<std::string, std::unordered_set<Instance*>> byTag;
+    Instance::TagCB onTag;
+    std::vector<TagEvent> pending;   // fired once the hierarchy change is complete
+};
+MembershipIndex& Index() {
+    static MembershipIndex* index = new MembershipIndex;   // outlives static Instances
+    return *index;
+}
+}
+
+void Instance::indexInsert() {
+    auto& idx = Index();
+    auto& list = idx.byClass[(size_t)Class];
+    classSlot_ = list.size();
+    list.push_back(this);
+    if (tags_) for (const auto& t : *tags_) idx.byTag[t].insert(this);
+}
+
+void Instance::indexErase() {
+    auto& idx = Index();
+    auto& list = idx.byClass[(size_t)Class];
+    if (classSlot_ < list.size() && list[classSlot_] == this) {
+        list[classSlot_] = list.back();
+        list[classSlot_]->classSlot_ = classSlot_;
+        list.pop_back();
+    }
+    classSlot_ = SIZE_MAX;
+    if (tags_) {
+        for (const auto& t : *tags_) {
+            auto it = idx.byTag.find(t);
+            if (it == idx.byTag.end()) continue;
+            it->second.erase(this);
+            if (it->second.empty()) idx.byTag.erase(it);
+        }
+    }
+}
+
+void Instance::setInDataModel(Instance* root, bool in) {
+    auto& idx = Index();
+    std::vector<Instance*> stack{ root };
+    while (!stack.empty()) {
+        Instance* n = stack.back(); stack.pop_back();
+        if (n->inDataModel_ == in) continue;
+        n->inDataModel_ = in;
+        if (in) n->indexInsert(); else n->indexErase();
+        if (n->tags_ && idx.onTag)
+            for (const auto& t : *n->tags_) idx.pending.push_back({ n->shared_from_this(), t, in });
+        for (const auto& c : n->Children) if (c) stack.push_back(c.get());
+    }
+}
+
+void Instance::flushTagEvents() {
+    auto& idx = Index();
+    if (idx.pending.empty()) return;
+    std::vector<TagEvent> events;
+    events.swap(idx.pending);
+    for (auto& e : events) if (idx.onTag) idx.onTag(e.inst, e.tag, e.added);
+}
+
+void Instance::SetTagListener(TagCB cb) { Index().onTag = std::move(cb); }
 
 // -------- ctors --------
-Instance::Instance(std::string name, InstanceClass c) : Name(std::move(name)), Class(c) {}
-Instance::~Instance() = default;
+Instance::Instance(std::string name, InstanceClass c) : Name(std::move(name)), Class(c) {
+    // the DataModel root is the one instance in it from the start
+    if (c == InstanceClass::Game) { inDataModel_ = true; indexInsert(); }
+}
+Instance::~Instance() {
+    if (inDataModel_) indexErase();
+}
 
 // instance classname mapping
 static const char* ToClassName(InstanceClass c) {
@@ -19,80 +100,243 @@ static const char* ToClassName(InstanceClass c) {
         case InstanceClass::Camera:      return "Camera";
         case InstanceClass::RunService:  return "RunService";
         case InstanceClass::Lighting:    return "Lighting";
+        case InstanceClass::Actor:       return "Actor";
+        case InstanceClass::CollectionService: return "CollectionService";
         default:                         return "Unknown";
     }
 }
 
+// -------- reflection --------
+const PropertyInfo* Instance::FindProperty(int atom) const {
+    const PropertyTable* props = Properties();
+    return props ? props->Find(atom) : nullptr;
+}
+
+bool Instance::LuaGet(lua_State* L, int atom) const {
+    const PropertyInfo* p = FindProperty(atom);
+    if (!p || (p->flags & Prop_Hidden)) return false;
+    p->get(L, this);
+    return true;
+}
+
+bool Instance::LuaSet(lua_State* L, int atom, int valueIndex) {
+    const PropertyInfo* p = FindProperty(atom);
+    if (!p || (p->flags & Prop_Hidden)) return false;
+    if (!p->set) luaL_error(L, "%s is read-only", p->Name());
+    p->set(L, this, valueIndex);
+    return true;
+}
+
 // -------- attributes --------
 void Instance::SetAttribute(const std::string& name, const Attribute& value) {
     if (name.empty()) return;
-    Attributes[name] = value;
+    attributes_.Get()[name] = value;
     LOGI("SetAttribute: %s.%s", Name.c_str(), name.c_str());
 }
 std::optional<Attribute> Instance::GetAttribute(const std::string& name) const {
-    auto it = Attributes.find(name);
-    if (it == Attributes.end()) return std::nullopt;
+    if (!attributes_) return std::nullopt;
+    auto it = attributes_->find(name);
+    if (it == attributes_->end()) return std::nullopt;
     return it->second;
 }
+const std::unordered_map<std::string, Attribute>& Instance::GetAttributes() const {
+    static const std::unordered_map<std::string, Attribute> kNone;
+    return attributes_ ? *attributes_ : kNone;
+}
+
+// -------- tags --------
+void Instance::AddTag(const std::string& tag) {
+    if (tag.empty() || HasTag(tag)) return;
+    tags_.Get().push_back(tag);
+    if (!inDataModel_) return;
+    auto& idx = Index();
+    idx.byTag[tag].insert(this);
+    if (idx.onTag) idx.onTag(shared_from_this(), tag, true);
+}
+
+void Instance::RemoveTag(const std::string& tag) {
+    if (!tags_) return;
+    auto it = std::find(tags_->begin(), tags_->end(), tag);
+    if (it == tags_->end()) return;
+    tags_->erase(it);
+    if (!inDataModel_) return;
+    auto& idx = Index();
+    auto set = idx.byTag.find(tag);
+    if (set != idx.byTag.end()) {
+        set->second.erase(this);
+        if (set->second.empty()) idx.byTag.erase(set);
+    }
+    if (idx.onTag) idx.onTag(shared_from_this(), tag, false);
+}
+
+bool Instance::HasTag(const std::string& tag) const {
+    return tags_ && std::find(tags_->begin(), tags_->end(), tag) != tags_->end();
+}
+
+std::vector<std::string> Instance::GetTags() const {
+    return tags_ ? *tags_ : std::vector<std::string>{};
+}
+
+std::vector<std::shared_ptr<Instance>> Instance::GetTagged(const std::string& tag) {
+    std::vector<std::shared_ptr<Instance>> out;
+    auto& idx = Index();
+    auto it = idx.byTag.find(tag);
+    if (it == idx.byTag.end()) return out;
+    out.reserve(it->second.size());
+    for (Instance* m : it->second) if (m->Alive) out.push_back(m->shared_from_this());
+    return out;
+}
 
 // -------- tiny signal system --------
-size_t Instance::OnChildAdded(CB cb){ auto id=nextId++; childAdded_[id]=std::move(cb); return id; }
-size_t Instance::OnChildRemoved(CB cb){ auto id=nextId++; childRemoved_[id]=std::move(cb); return id; }
-size_t Instance::OnDescendantAdded(CB cb){ auto id=nextId++; descAdded_[id]=std::move(cb); return id; }
-size_t Instance::OnDescendantRemoved(CB cb){ auto id=nextId++; descRemoved_[id]=std::move(cb); return id; }
+static size_t connect(size_t& nextId, std::unordered_map<size_t, Instance::CB>& to, Instance::CB cb) {
+    const size_t id = nextId++;
+    to[id] = std::move(cb);
+    return id;
+}
+size_t Instance::OnChildAdded(CB cb){ auto& l=listeners_.Get(); return connect(l.nextId, l.childAdded, std::move(cb)); }
+size_t Instance::OnChildRemoved(CB cb){ auto& l=listeners_.Get(); return connect(l.nextId, l.childRemoved, std::move(cb)); }
+size_t Instance::OnDescendantAdded(CB cb){ auto& l=listeners_.Get(); return connect(l.nextId, l.descAdded, std::move(cb)); }
+size_t Instance::OnDescendantRemoved(CB cb){ auto& l=listeners_.Get(); return connect(l.nextId, l.descRemoved, std::move(cb)); }
 void   Instance::Disconnect(size_t id){
-    childAdded_.erase(id); childRemoved_.erase(id); descAdded_.erase(id); descRemoved_.erase(id);
+    if (!listeners_) return;
+    listeners_->childAdded.erase(id); listeners_->childRemoved.erase(id);
+    listeners_->descAdded.erase(id);  listeners_->descRemoved.erase(id);
+}
+void Instance::fireChildAdded(const std::shared_ptr<Instance>& c){ if (listeners_) for(auto& kv:listeners_->childAdded) kv.second(c); }
+void Instance::fireChildRemoved(const std::shared_ptr<Instance>& c){ if (listeners_) for(auto& kv:listeners_->childRemoved) kv.second(c); }
+void Instance::fireDescendantAdded(const std::shared_ptr<Instance>& c){ if (listeners_) for(auto& kv:listeners_->descAdded) kv.second(c); }
+void Instance::fireDescendantRemoved(const std::shared_ptr<Instance>& c){ if (listeners_) for(auto& kv:listeners_->descRemoved) kv.second(c); }
+
+// -------- hierarchy bookkeeping --------
+void Instance::attachChild(const std::shared_ptr<Instance>& c) {
+    childrenVersion_++;
+    c->indexInParent = Children.size();
+    Children.push_back(c);
+    childrenByName_.Get()[c->Name] = c;
+    addDescendantCount(c->descendantCount_ + 1, true);
+    if (inDataModel_) setInDataModel(c.get(), true);
 }
-void Instance::fireChildAdded(const std::shared_ptr<Instance>& c){ for(auto& kv:childAdded_) kv.second(c); }
-void Instance::fireChildRemoved(const std::shared_ptr<Instance>& c){ for(auto& kv:childRemoved_) kv.second(c); }
-void Instance::fireDescendantAdded(const std::shared_ptr<Instance>& c){ for(auto& kv:descAdded_) kv.second(c); }
-void Instance::fireDescendantRemoved(const std::shared_ptr<Instance>& c){ for(auto& kv:descRemoved_) kv.second(c); }
 
-// helper: apply f to node and all descendants
-static void forEachDesc(const std::shared_ptr<Instance>& n,
-                        const std::function<void(const std::shared_ptr<Instance>&)>& f){
-    if (!n) return;
-    f(n);
-    for (auto& ch : n->Children) if (ch) forEachDesc(ch, f);
+void Instance::addDescendantCount(size_t n, bool add) {
+    descendantCount_ = add ? descendantCount_ + n : descendantCount_ - n;
+    for (auto a = Parent.lock(); a; a = a->Parent.lock())
+        a->descendantCount_ = add ? a->descendantCount_ + n : a->descendantCount_ - n;
+}
+
+void Instance::detachChild(Instance* c) {
+    const size_t i = c->indexInParent;
+    if (i >= Children.size() || Children[i].get() != c) return;
+    childrenVersion_++;
+    addDescendantCount(c->descendantCount_ + 1, false);
+    if (c->inDataModel_) setInDataModel(c, false);
+    if (i + 1 != Children.size()) {
+        Children[i] = std::move(Children.back());
+        Children[i]->indexInParent = i;
+    }
+    Children.pop_back();
+    c->indexInParent = SIZE_MAX;
+
+    if (!childrenByName_) return;
+    auto it = childrenByName_->find(c->Name);
+    if (it != childrenByName_->end() && it->second.get() == c) childrenByName_->erase(it);
+}
+
+void Instance::fireSubtree(const std::shared_ptr<Instance>& from, const std::shared_ptr<Instance>* roots, size_t count, bool added) {
+    // most ancestors have no descendant listeners; skip the walk when none do
+    std::vector<std::shared_ptr<Instance>> listeners;
+    for (auto a = from; a; a = a->Parent.lock())
+        if (a->listeners_ && !(added ? a->listeners_->descAdded : a->listeners_->descRemoved).empty()) listeners.push_back(a);
+    if (listeners.empty()) return;
+
+    // pre-order, children in order
+    std::vector<std::shared_ptr<Instance>> stack(std::make_reverse_iterator(roots + count), std::make_reverse_iterator(roots));
+    while (!stack.empty()) {
+        auto n = std::move(stack.back()); stack.pop_back();
+        if (!n) continue;
+        for (auto& a : listeners) {
+            if (added) a->fireDescendantAdded(n);
+            else       a->fireDescendantRemoved(n);
+        }
+        for (auto it = n->Children.rbegin(); it != n->Children.rend(); ++it)
+            if (*it) stack.push_back(*it);
+    }
 }
 
 // -------- parenting --------
+bool Instance::canMoveTo(const std::shared_ptr<Instance>& parent) const {
+    if (!IsService()) return true;
+    if (!Parent.expired()) return false;                     // lock after first set
+    return parent && parent->Class == InstanceClass::Game;
+}
+
 void Instance::SetParent(const std::shared_ptr<Instance>& parent) {
     auto self = shared_from_this();
-
-    if (IsService()) {
-        if (!Parent.expired()) return;                       // lock after first set
-        if (!(parent && parent->Class == InstanceClass::Game)) return;
-    }
+    if (!canMoveTo(parent)) return;
 
     // detach from old
     if (auto old = Parent.lock()) {
-        old->Children.erase(std::remove(old->Children.begin(), old->Children.end(), self), old->Children.end());
-        auto it = old->ChildrenByName.find(Name);
-        if (it != old->ChildrenByName.end() && it->second.get() == this) old->ChildrenByName.erase(it);
+        old->detachChild(this);
 
         // direct child removed
         old->fireChildRemoved(self);
         // subtree: notify all ancestors of old
-        for (auto a = old; a; a = a->Parent.lock()) {
-            forEachDesc(self, [&](const std::shared_ptr<Instance>& d){ a->fireDescendantRemoved(d); });
-        }
+        fireSubtree(old, &self, 1, false);
     }
 
     Parent = parent;
 
-    // attach to new
+    // attach to new. DescendantAdded stays synchronous, unlike the part
+    // registration it triggers: Workspace only queues the part for the frame
+    // flush, and a same-frame DescendantRemoved must find it already added.
+    // Deferring the event would also reorder it against ChildAdded and the
+    // script-visible signals.
     if (parent) {
-        parent->Children.push_back(self);
-        parent->ChildrenByName[Name] = self;
+        parent->attachChild(self);
 
         // direct child added
         parent->fireChildAdded(self);
         // subtree: notify all ancestors of new
-        for (auto a = parent; a; a = a->Parent.lock()) {
-            forEachDesc(self, [&](const std::shared_ptr<Instance>& d){ a->fireDescendantAdded(d); });
+        fireSubtree(parent, &self, 1, true);
+    }
+    flushTagEvents();
+}
+
+void Instance::SetParentAll(const std::vector<std::shared_ptr<Instance>>& children, const std::shared_ptr<Instance>& parent) {
+    if (!parent) {
+        for (const auto& c : children) if (c) c->SetParent(nullptr);
+        return;
+    }
+
+    // Three passes, so listeners never see a half-applied batch: every
+    // removal fires before anything is attached, and the additions fire
+    // once all of them are in place
+    std::vector<std::shared_ptr<Instance>> moved;
+    moved.reserve(children.size());
+    std::unordered_set<const Instance*> seen;
+    for (const auto& c : children) {
+        if (!c || !c->Alive || !c->canMoveTo(parent)) continue;
+        if (c->Parent.lock() == parent || !seen.insert(c.get()).second) continue;
+        if (auto old = c->Parent.lock()) {
+            old->detachChild(c.get());
+            old->fireChildRemoved(c);
+            fireSubtree(old, &c, 1, false);
         }
+        c->Parent.reset();
+        moved.push_back(c);
+    }
+
+    // a removal listener may have destroyed or reparented one of them
+    moved.erase(std::remove_if(moved.begin(), moved.end(), [](const std::shared_ptr<Instance>& c) {
+        return !c->Alive || !c->Parent.expired();
+    }), moved.end());
+    for (const auto& c : moved) {
+        c->Parent = parent;
+        parent->attachChild(c);
     }
+
+    for (const auto& c : moved) parent->fireChildAdded(c);
+    fireSubtree(parent, moved.data(), moved.size(), true);
+    flushTagEvents();
 }
 
 // -------- destroy --------
@@ -105,22 +349,22 @@ void Instance::Destroy() {
 
     // notify and detach from parent first
     if (auto p = Parent.lock()) {
-        p->Children.erase(std::remove(p->Children.begin(), p->Children.end(), self), p->Children.end());
-        auto it = p->ChildrenByName.find(Name);
-        if (it != p->ChildrenByName.end() && it->second.get() == this) p->ChildrenByName.erase(it);
+        p->detachChild(this);
 
         p->fireChildRemoved(self);
-        for (auto a = p; a; a = a->Parent.lock()) {
-            forEachDesc(self, [&](const std::shared_ptr<Instance>& d){ a->fireDescendantRemoved(d); });
-        }
+        fireSubtree(p, &self, 1, false);
     }
     Parent.reset();
 
-    // destroy children
-    for (auto& c : Children) if (c) c->Destroy();
-    Children.clear();
-    ChildrenByName.clear();
-    Attributes.clear();
+    // destroy children from the back; each one detaches itself in O(1)
+    while (!Children.empty()) {
+        auto c = Children.back();
+        c->Destroy();
+        if (!Children.empty() && Children.back() == c) Children.pop_back();   // already dead
+    }
+    childrenByName_.ptr.reset();
+    attributes_.ptr.reset();
+    flushTagEvents();
 }
 
 void Instance::LegacyFunctionRemove() {
@@ -128,72 +372,120 @@ void Instance::LegacyFunctionRemove() {
     SetParent(nullptr);
 }
 
-std::shared_ptr<Instance> Instance::Clone() const {
-    if (IsService()) return nullptr;
-    using Map = CloneMap;
-    Map map;
+// -------- cloning --------
+// The subtree under a cloned instance, flattened in pre-order: each node's
+// source, its type and the index of its parent. Property values and names are
+// read from the live sources on every clone, so only structural changes make
+// a template stale; each node records its childrenVersion_ to detect them.
+struct Instance::CloneTemplate {
+    static constexpr uint32_t kRoot = UINT32_MAX;
+
+    struct Node {
+        const Instance* src;
+        const TypeInfo* type;
+        uint32_t parent;            // index into nodes, kRoot for the first
+        uint32_t childrenVersion;
+    };
+    std::vector<Node> nodes;
+    bool remaps = false;            // some class overrides RemapReferences
+
+    // Pre-order, so a node's parent is checked (and found unchanged, hence
+    // still holding the node) before the node itself is touched
+    bool Valid() const {
+        for (const Node& n : nodes)
+            if (n.src->childrenVersion_ != n.childrenVersion) return false;
+        return true;
+    }
+};
 
-    // Pass 1: build an isomorphic tree with copied derived fields.
-    std::function<std::shared_ptr<Instance>(const Instance*)> build =
-    [&](const Instance* src) -> std::shared_ptr<Instance> {
-        if (!src || !src->Alive) return nullptr;
+const Instance::CloneTemplate& Instance::cloneTemplate() const {
+    CloneTemplate& t = cloneTemplate_.Get();
+    if (!t.nodes.empty() && t.Valid()) return t;
 
+    t.nodes.clear();
+    t.remaps = false;
+    std::vector<std::pair<const Instance*, uint32_t>> stack{ { this, CloneTemplate::kRoot } };
+    while (!stack.empty()) {
+        auto [src, parent] = stack.back(); stack.pop_back();
         auto it = types().find(src->GetClassName());
-        if (it == types().end()) return nullptr;
+        if (it == types().end()) continue;   // and its subtree
 
-        auto dst = (it->second.factory)();
-        if (!dst) return nullptr;
+        const uint32_t index = (uint32_t)t.nodes.size();
+        t.nodes.push_back({ src, &it->second, parent, src->childrenVersion_ });
+        t.remaps |= it->second.remaps;
+        for (auto ch = src->Children.rbegin(); ch != src->Children.rend(); ++ch)
+            if (*ch && (*ch)->Alive) stack.push_back({ ch->get(), index });
+    }
+    return t;
+}
 
-        // Copy all derived fields
-        (it->second.copier)(src, dst.get());
+std::shared_ptr<Instance> Instance::Clone() const {
+    if (IsService() || !Alive) return nullptr;
+    const CloneTemplate& t = cloneTemplate();
+    if (t.nodes.empty()) return nullptr;
+
+    // One pass over the template; children attach without firing signals
+    std::vector<std::shared_ptr<Instance>> out(t.nodes.size());
+    for (size_t i = 0; i < t.nodes.size(); ++i) {
+        const CloneTemplate::Node& n = t.nodes[i];
+        const Instance* src = n.src;
+        Instance* parent = n.parent == CloneTemplate::kRoot ? nullptr : out[n.parent].get();
+        if (n.parent != CloneTemplate::kRoot && !parent) continue;   // parent's factory failed
+
+        auto dst = (n.type->factory)();
+        if (!dst) continue;
+
+        // Copy derived state: reflected classes through their properties,
+        // others by assignment
+        if (const PropertyTable* props = src->Properties()) props->CopyValues(src, dst.get());
+        else (n.type->copier)(src, dst.get());
 
         // Sanitize base
         dst->Parent.reset();
+        dst->indexInParent = SIZE_MAX;
+        dst->descendantCount_ = 0;
+        dst->inDataModel_  = false;
+        dst->classSlot_    = SIZE_MAX;
         dst->Children.clear();
-        dst->ChildrenByName.clear();
-        dst->childAdded_.clear();
-        dst->childRemoved_.clear();
-        dst->descAdded_.clear();
-        dst->descRemoved_.clear();
-        dst->nextId = 1;
+        dst->childrenByName_.ptr.reset();
+        dst->listeners_.ptr.reset();
 
         // Reapply canonical base values
         dst->Name       = src->Name;
         dst->Class      = src->Class;
         dst->Alive      = true;
-        dst->Attributes = src->Attributes;
-
-        map.emplace(src, dst);
-
-        // Children without firing signals
-        for (const auto& ch : src->Children) {
-            if (!ch || !ch->Alive) continue;
-            auto cc = build(ch.get());
-            if (!cc) continue;
-            cc->Parent = dst;
-            dst->Children.push_back(cc);
-            dst->ChildrenByName[cc->Name] = cc;
+        if (src->attributes_) dst->attributes_.Get() = *src->attributes_;
+        else dst->attributes_.ptr.reset();
+        if (src->tags_) dst->tags_.Get() = *src->tags_;
+        else dst->tags_.ptr.reset();
+
+        if (parent) {
+            dst->Parent = out[n.parent];
+            parent->attachChild(dst);
         }
-        return dst;
-    };
-
-    auto root = build(this);
-    if (!root) return nullptr;
-
-    // Pass 2: fix intra-tree references in derived data.
-    for (auto& kv : map) kv.second->RemapReferences(map);
-
-    return root;
+        out[i] = std::move(dst);
+    }
+    if (!out[0]) return nullptr;
+
+    // Fix intra-tree references in derived data, for the classes that have any
+    if (t.remaps) {
+        CloneMap map;
+        map.reserve(out.size());
+        for (size_t i = 0; i < out.size(); ++i) if (out[i]) map.emplace(t.nodes[i].src, out[i]);
+        for (auto& kv : map) kv.second->RemapReferences(map);
+    }
+    return std::move(out[0]);
 }
 
 void Instance::SetName(const std::string& newName) {
     if (Name == newName) return;
     if (auto p = Parent.lock()) {
-        auto it = p->ChildrenByName.find(Name);
-        if (it != p->ChildrenByName.end() && it->second.get() == this) {
-            p->ChildrenByName.erase(it);
+        auto& byName = p->childrenByName_.Get();
+        auto it = byName.find(Name);
+        if (it != byName.end() && it->second.get() == this) {
+            byName.erase(it);
         }
-        p->ChildrenByName[newName] = shared_from_this();
+        byName[newName] = shared_from_this();
     }
     Name = newName;
 }
@@ -213,12 +505,12 @@ std::string Instance::GetClassName() const {
     return ToClassName(Class);
 }
 
-bool Instance::IsA(const std::string& className) const {
+bool Instance::ClassIsA(InstanceClass c, const std::string& className) {
     if (className == "Instance") return true;
-    if (className == ToClassName(Class)) return true;
+    if (className == ToClassName(c)) return true;
 
     // simple inheritance/aliases
-    switch (Class) {
+    switch (c) {
         case InstanceClass::LocalScript:
         case InstanceClass::Script:
             if (className == "BaseScript" || className == "LuaSourceContainer") return true;
@@ -256,18 +548,70 @@ std::vector<std::shared_ptr<Instance>> Instance::GetDescendants() const {
     return out;
 }
 
+// Resolves the name once, so the loops below compare enums
+static void ClassMask(const std::string& className, bool exact, bool (&mask)[kInstanceClassCount]) {
+    for (size_t k = 0; k < kInstanceClassCount; ++k) {
+        const InstanceClass c = (InstanceClass)k;
+        mask[k] = exact ? className == ToClassName(c) : Instance::ClassIsA(c, className);
+    }
+}
+
 std::shared_ptr<Instance> Instance::FindFirstChildOfClass(const std::string& className) const {
+    bool mask[kInstanceClassCount];
+    ClassMask(className, true, mask);
     for (const auto& c : Children)
-        if (c && c->Alive && c->GetClassName() == className) return c;
+        if (c && c->Alive && mask[(size_t)c->Class]) return c;
     return nullptr;
 }
 
 std::shared_ptr<Instance> Instance::FindFirstChildWhichIsA(const std::string& className) const {
+    bool mask[kInstanceClassCount];
+    ClassMask(className, false, mask);
     for (const auto& c : Children)
-        if (c && c->Alive && c->IsA(className)) return c;
+        if (c && c->Alive && mask[(size_t)c->Class]) return c;
     return nullptr;
 }
 
+std::vector<std::shared_ptr<Instance>> Instance::QueryDescendants(const std::string& className) const {
+    std::vector<std::shared_ptr<Instance>> out;
+    bool mask[kInstanceClassCount];
+    ClassMask(className, false, mask);
+
+    // The class index costs an ancestor walk per member unless this is the
+    // root; walk the subtree instead when it is the smaller of the two
+    const bool fromRoot = Class == InstanceClass::Game;
+    size_t classed = 0;
+    if (inDataModel_ && !fromRoot)
+        for (size_t k = 0; k < kInstanceClassCount; ++k)
+            if (mask[k]) classed += Index().byClass[k].size();
+
+    if (!inDataModel_ || (!fromRoot && descendantCount_ <= classed)) {
+        std::vector<const Instance*> stack{ this };
+        while (!stack.empty()) {
+            const Instance* n = stack.back(); stack.pop_back();
+            for (const auto& c : n->Children) {
+                if (!c || !c->Alive) continue;
+                if (mask[(size_t)c->Class]) out.push_back(c);
+                stack.push_back(c.get());
+            }
+        }
+        return out;
+    }
+
+    // every indexed instance descends from the DataModel root
+    auto& idx = Index();
+    for (size_t k = 0; k < kInstanceClassCount; ++k) {
+        if (!mask[k]) continue;
+        for (Instance* m : idx.byClass[k]) {
+            if (m == this || !m->Alive) continue;
+            bool under = fromRoot;
+            for (auto a = m->Parent.lock(); a && !under; a = a->Parent.lock()) under = a.get() == this;
+            if (under) out.push_back(m->shared_from_this());
+        }
+    }
+    return out;
+}
+
 std::shared_ptr<Instance> Instance::FindFirstAncestor(const std::string& name) const {
     for (auto a = Parent.lock(); a; a = a->Parent.lock())
         if (a->Alive && a->Name == name) return a;
@@ -301,14 +645,15 @@ bool Instance::IsAncestorOf(const std::shared_ptr<Instance>& other) const {
 }
 
 void Instance::ClearAllChildren() {
-    // Snapshot first; Destroy() mutates parent->Children.
-    auto cur = Children;
-    for (auto& c : cur) {
-        if (c && c->Alive) c->Destroy(); // recursive by design
+    // Destroy() swap-removes each child from Children; take them from the back.
+    while (!Children.empty()) {
+        auto c = Children.back();
+        c->Destroy(); // recursive by design
+        if (!Children.empty() && Children.back() == c) Children.pop_back();
     }
     // Ensure containers are empty even if a child skipped notifications.
     Children.clear();
-    ChildrenByName.clear();
+    childrenByName_.ptr.reset();
 }
 
 // -------- factory --------
@@ -339,4 +684,48 @@ std::shared_ptr<Instance> Instance::New(const std::string& typeName) {
     if (it != types().end()) return (it->second.factory)();
     LOGW("Instance::New: unknown type '%s'", typeName.c_str());
     return nullptr;
-}
\ No newline at end of file
+}
+// -------- memory report --------
+// bucket array plus one node (value, next pointer, cached hash) per entry
+template <class M>
+static size_t mapBytes(const M& m) {
+    return sizeof(M) + m.bucket_count() * sizeof(void*) + m.size() * (sizeof(typename M::value_type) + 2 * sizeof(void*));
+}
+
+void Instance::LogMemoryReport(const std::shared_ptr<Instance>& root) {
+    if (!root) return;
+
+    struct Row { size_t count = 0, object = 0, heap = 0; };
+    std::map<std::string, Row> rows;
+    const size_t inlineName = std::string().capacity();
+
+    auto visit = [&](const Instance& n) {
+        const std::string cls = n.GetClassName();
+        Row& r = rows[cls];
+        auto it = types().find(cls);
+        r.count++;
+        r.object += it != types().end() ? it->second.size : sizeof(Instance);
+
+        size_t heap = n.Children.capacity() * sizeof(std::shared_ptr<Instance>);
+        if (n.Name.capacity() > inlineName) heap += n.Name.capacity() + 1;
+        if (n.childrenByName_) heap += mapBytes(*n.childrenByName_);
+        if (n.attributes_)     heap += mapBytes(*n.attributes_);
+        if (n.listeners_) {
+            heap += sizeof(Listeners);
+            heap += mapBytes(n.listeners_->childAdded) + mapBytes(n.listeners_->childRemoved);
+            heap += mapBytes(n.listeners_->descAdded)  + mapBytes(n.listeners_->descRemoved);
+        }
+        r.heap += heap;
+    };
+    visit(*root);
+    for (const auto& d : root->GetDescendants()) visit(*d);
+
+    LOGI("Instance memory under '%s' (approximate):", root->Name.c_str());
+    for (const auto& [cls, r] : rows) {
+        LOGI("  %-12s %6zu x %6zu B/instance  (objects %zu B, containers %zu B)",
+             cls.c_str(), r.count, (r.object + r.heap) / r.count, r.object, r.heap);
+    }
+    for (const BlockPool* p : BlockPool::All()) {
+        LOGI("  pool %4zu B blocks: %zu live, %zu reserved", p->BlockSize(), p->Live(), p->Reserved());
+    }
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -12,24 +13,42 @@
 // Raylib
 #include <raylib.h>
 
+#include "bootstrap/InstancePool.h"
+
 // Forward declare Lua to avoid coupling headers to Lua includes
 struct lua_State;
+struct PropertyInfo;
+class PropertyTable;
 
-enum class InstanceClass { Game, Workspace, Part, Script, LocalScript, Folder, Camera, RunService, Lighting, Unknown };
+enum class InstanceClass { Game, Workspace, Part, Script, LocalScript, Folder, Camera, RunService, Lighting, Actor, CollectionService, Unknown };
+constexpr size_t kInstanceClassCount = (size_t)InstanceClass::Unknown + 1;
 using Attribute = std::variant<bool,double,std::string,::Vector3,::Color>;
 
+// Heap state most instances never use (name index, attributes, listeners),
+// allocated on first write. Copies start empty, like PartProxy, so Clone()'s
+// by-assignment copier never shares it; Clone() copies what it keeps itself.
+template <class T>
+struct Lazy {
+    std::unique_ptr<T> ptr;
+
+    Lazy() = default;
+    Lazy(const Lazy&) {}
+    Lazy& operator=(const Lazy&) { return *this; }
+
+    T& Get() { if (!ptr) ptr = std::make_unique<T>(); return *ptr; }
+    T* operator->() const { return ptr.get(); }
+    T& operator*() const { return *ptr; }
+    explicit operator bool() const { return ptr != nullptr; }
+};
+
 struct Instance : std::enable_shared_from_this<Instance> {
     // -------- core state --------
     std::string Name;
     InstanceClass Class{ InstanceClass::Unknown };
     std::weak_ptr<Instance> Parent;
-    std::vector<std::shared_ptr<Instance>> Children;
-    std::unordered_map<std::string, std::shared_ptr<Instance>> ChildrenByName;
+    std::vector<std::shared_ptr<Instance>> Children;   // unordered: a removal moves the last child into its slot
     bool Alive{ true };
 
-    // Attributes
-    std::unordered_map<std::string, Attribute> Attributes;
-
     // -------- ctor/dtor --------
     Instance(std::string name, InstanceClass c);
     virtual ~Instance();
@@ -37,18 +56,23 @@ struct Instance : std::enable_shared_from_this<Instance> {
     // -------- lifetime --------
     virtual void Destroy();
     void SetParent(const std::shared_ptr<Instance>& parent);
+    // SetParent for a batch: all removals fire first, then ChildAdded per child
+    // and one DescendantAdded walk over all of them instead of one per child
+    static void SetParentAll(const std::vector<std::shared_ptr<Instance>>& children, const std::shared_ptr<Instance>& parent);
     void LegacyFunctionRemove();
 
     // -------- queries --------
     std::string GetClassName() const;
-    bool IsA(const std::string& className) const;
+    bool IsA(const std::string& className) const { return ClassIsA(Class, className); }
+    static bool ClassIsA(InstanceClass c, const std::string& className);
     void SetName(const std::string& newName);
     std::string GetFullName() const;
 
     // -------- queries --------
     std::shared_ptr<Instance> FindFirstChild(const std::string& name) {
-        auto it = ChildrenByName.find(name);
-        return it == ChildrenByName.end() ? nullptr : it->second;
+        if (!childrenByName_) return nullptr;
+        auto it = childrenByName_->find(name);
+        return it == childrenByName_->end() ? nullptr : it->second;
     }
     std::shared_ptr<Instance> FindFirstChildOfClass(const std::string& className) const;
     std::shared_ptr<Instance> FindFirstChildWhichIsA(const std::string& className) const;
@@ -59,6 +83,10 @@ struct Instance : std::enable_shared_from_this<Instance> {
     std::vector<std::shared_ptr<Instance>> GetChildren() const;
     std::vector<std::shared_ptr<Instance>> GetDescendants() const;
 
+    // Descendants that IsA(className). Served from the class index (no tree
+    // walk) when this instance is in the DataModel.
+    std::vector<std::shared_ptr<Instance>> QueryDescendants(const std::string& className) const;
+
     bool IsDescendantOf(const std::shared_ptr<Instance>& other) const;
     bool IsAncestorOf(const std::shared_ptr<Instance>& other) const;
     void ClearAllChildren();
@@ -66,7 +94,23 @@ struct Instance : std::enable_shared_from_this<Instance> {
     // -------- attributes API --------
     void SetAttribute(const std::string& name, const Attribute& value);
     std::optional<Attribute> GetAttribute(const std::string& name) const;
-    const std::unordered_map<std::string, Attribute>& GetAttributes() const { return Attributes; }
+    const std::unordered_map<std::string, Attribute>& GetAttributes() const;
+
+    // -------- tags (CollectionService) --------
+    void AddTag(const std::string& tag);
+    void RemoveTag(const std::string& tag);
+    bool HasTag(const std::string& tag) const;
+    std::vector<std::string> GetTags() const;
+
+    // Tagged instances in the DataModel
+    static std::vector<std::shared_ptr<Instance>> GetTagged(const std::string& tag);
+    // Told when an instance with 'tag' enters or leaves the DataModel, or gains
+    // or loses the tag inside it. One listener (CollectionService).
+    using TagCB = std::function<void(const std::shared_ptr<Instance>&, const std::string& tag, bool added)>;
+    static void SetTagListener(TagCB cb);
+
+    // The DataModel (game) or one of its descendants; only those are indexed
+    bool InDataModel() const { return inDataModel_; }
 
     // -------- signals --------
     using CB = std::function<void(const std::shared_ptr<Instance>&)>;
@@ -79,15 +123,24 @@ struct Instance : std::enable_shared_from_this<Instance> {
     // -------- cloning --------
     using CloneMap = std::unordered_map<const Instance*, std::shared_ptr<Instance>>;
 
+    // Repeat clones of an unchanged subtree replay a cached flat template
     std::shared_ptr<Instance> Clone() const;
     virtual void RemapReferences(const CloneMap&) {}
     virtual bool IsService() const { return false; }
     
+    // -------- reflection --------
+    // The class's property table (bootstrap/Reflection.h), or nullptr
+    virtual const PropertyTable* Properties() const { return nullptr; }
+    const PropertyInfo* FindProperty(int atom) const;
+
     // -------- Lua property hooks (object-specific, but out of ScriptingAPI) --------
+    // 'atom' is the key's LuaAtom (see bootstrap/LuaAtoms.h); only called for engine names.
     // Return true if handled. For reads, you must push a Lua value onto the stack.
-    virtual bool LuaGet(lua_State* L, const char* key) const { (void)L; (void)key; return false; }
+    // The defaults serve the class's reflected properties; override for members
+    // that are not properties (methods, signals) and fall back to these.
+    virtual bool LuaGet(lua_State* L, int atom) const;
     // For writes, read the value at 'valueIndex'.
-    virtual bool LuaSet(lua_State* L, const char* key, int valueIndex) { (void)L; (void)key; (void)valueIndex; return false; }
+    virtual bool LuaSet(lua_State* L, int atom, int valueIndex);
 
 protected:
     // Helpers for RemapReferences implementations
@@ -120,10 +173,21 @@ public:
     struct TypeInfo {
         Factory factory;
         Copier  copier;
+        size_t  size = 0;        // sizeof the class, for the memory report
+        bool    remaps = false;  // overrides RemapReferences
     };
 
     static std::shared_ptr<Instance> New(const std::string& typeName);
 
+    // make_shared from the class's BlockPool; factories use this
+    template <class T, class... Args>
+    static std::shared_ptr<T> Make(Args&&... args) {
+        return std::allocate_shared<T>(PoolAllocator<T>{}, std::forward<Args>(args)...);
+    }
+
+    // Logs instance count and approximate bytes per class under 'root'
+    static void LogMemoryReport(const std::shared_ptr<Instance>& root);
+
     struct Registrar {
         template <class F>
         Registrar(const char* type, F&& f) {
@@ -139,18 +203,53 @@ public:
                 auto* dd = static_cast<Derived*>(d);
                 *dd = *sd;
             };
+            ti.size = sizeof(Derived);
+            ti.remaps = !std::is_same_v<decltype(&Derived::RemapReferences), void (Instance::*)(const CloneMap&)>;
             types().emplace(type, std::move(ti));
         }
     };
 
 private:
-    size_t nextId{1};
-    std::unordered_map<size_t, CB> childAdded_, childRemoved_, descAdded_, descRemoved_;
+    struct Listeners {
+        size_t nextId{1};
+        std::unordered_map<size_t, CB> childAdded, childRemoved, descAdded, descRemoved;
+    };
+    Lazy<Listeners> listeners_;
+    Lazy<std::unordered_map<std::string, std::shared_ptr<Instance>>> childrenByName_;
+    Lazy<std::unordered_map<std::string, Attribute>> attributes_;
 
     void fireChildAdded(const std::shared_ptr<Instance>& c);
     void fireChildRemoved(const std::shared_ptr<Instance>& c);
     void fireDescendantAdded(const std::shared_ptr<Instance>& c);
     void fireDescendantRemoved(const std::shared_ptr<Instance>& c);
 
+    // -------- hierarchy bookkeeping --------
+    size_t indexInParent{ SIZE_MAX };   // slot in Parent's Children
+    uint32_t childrenVersion_{ 0 };     // bumped whenever Children changes
+    size_t descendantCount_{ 0 };       // subtree size, for QueryDescendants' plan
+
+    // -------- class/tag indices --------
+    bool inDataModel_{ false };
+    size_t classSlot_{ SIZE_MAX };               // slot in the class index
+    Lazy<std::vector<std::string>> tags_;
+
+    void indexInsert();
+    void indexErase();
+    static void setInDataModel(Instance* root, bool in);
+    static void flushTagEvents();
+
+    // Clone()'s flattened copy of this subtree, kept between clones
+    struct CloneTemplate;
+    mutable Lazy<CloneTemplate> cloneTemplate_;
+    const CloneTemplate& cloneTemplate() const;
+
+    void attachChild(const std::shared_ptr<Instance>& c);
+    void addDescendantCount(size_t n, bool add);   // on this and every ancestor
+    void detachChild(Instance* c);
+    bool canMoveTo(const std::shared_ptr<Instance>& parent) const;
+    // DescendantAdded/Removed for each root and its subtree on 'from' and every
+    // ancestor of it, in one walk
+    static void fireSubtree(const std::shared_ptr<Instance>& from, const std::shared_ptr<Instance>* roots, size_t count, bool added);
+
     static std::unordered_map<std::string, TypeInfo>& types();
 };
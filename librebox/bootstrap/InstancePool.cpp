@@ -0,0 +1,40 @@
+// ================== bootstrap/InstancePool.cpp ==================
+#include "bootstrap/InstancePool.h"
+
+static std::vector<BlockPool*>& Registry() {
+    static std::vector<BlockPool*>* pools = new std::vector<BlockPool*>;
+    return *pools;
+}
+
+BlockPool::BlockPool(size_t blockSize, size_t align) : blockSize(blockSize), align(align) {
+    Registry().push_back(this);
+}
+
+std::vector<BlockPool*> BlockPool::All() {
+    return Registry();
+}
+
+void* BlockPool::Allocate() {
+    if (!freeList) {
+        std::byte* chunk = static_cast<std::byte*>(::operator new(blockSize * kBlocksPerChunk, std::align_val_t(align)));
+        chunks.push_back(chunk);
+        for (size_t i = kBlocksPerChunk; i-- > 0;) {
+            auto* b = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+            b->next = freeList;
+            freeList = b;
+        }
+        reserved += kBlocksPerChunk;
+    }
+    FreeBlock* b = freeList;
+    freeList = b->next;
+    live++;
+    return b;
+}
+
+void BlockPool::Free(void* p) {
+    if (!p) return;
+    auto* b = static_cast<FreeBlock*>(p);
+    b->next = freeList;
+    freeList = b;
+    live--;
+}
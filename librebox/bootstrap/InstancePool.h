@@ -0,0 +1,78 @@
+// ================== bootstrap/InstancePool.h ==================
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Fixed-size block pool. Instance classes allocate through PoolAllocator, so
+// every class (its object and shared_ptr control block together) gets a pool
+// of its own size: mass-created parts come out of 64-block chunks instead of
+// one malloc each, and a destroyed part's block goes to the next new one.
+// Chunks are never returned to the system.
+//
+// Main thread only, like the rest of the Instance tree: instances are
+// created in the serial phase, and the actors' GC is stopped during the
+// parallel phase (LuaScheduler::RunParallelPhase) so the last reference to
+// one is also dropped on the main thread. The pool takes no lock.
+class BlockPool {
+public:
+    BlockPool(size_t blockSize, size_t align);
+
+    void* Allocate();
+    void  Free(void* p);
+
+    size_t BlockSize() const { return blockSize; }
+    size_t Live() const { return live; }
+    size_t Reserved() const { return reserved; }   // blocks in all chunks
+
+    // Every pool created so far (for the memory report)
+    static std::vector<BlockPool*> All();
+
+    // One pool per block shape; never destroyed, so Instances released
+    // during static destruction still have somewhere to go
+    template <size_t Size, size_t Align>
+    static BlockPool& For() {
+        static BlockPool* pool = new BlockPool(Size, Align);
+        return *pool;
+    }
+
+private:
+    static constexpr size_t kBlocksPerChunk = 64;
+
+    struct FreeBlock { FreeBlock* next; };
+
+    size_t blockSize;
+    size_t align;
+    FreeBlock* freeList{nullptr};
+    std::vector<void*> chunks;
+    size_t live{0};
+    size_t reserved{0};
+};
+
+// Allocator for std::allocate_shared; n == 1 requests (the only kind
+// allocate_shared makes) come from the pool for T's size
+template <class T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <class U> PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (n != 1) return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        return static_cast<T*>(Pool().Allocate());
+    }
+    void deallocate(T* p, size_t n) {
+        if (n != 1) { ::operator delete(p, std::align_val_t(alignof(T))); return; }
+        Pool().Free(p);
+    }
+
+    template <class U> bool operator==(const PoolAllocator<U>&) const { return true; }
+    template <class U> bool operator!=(const PoolAllocator<U>&) const { return false; }
+
+private:
+    static constexpr size_t kAlign = alignof(T) < alignof(void*) ? alignof(void*) : alignof(T);
+    static constexpr size_t kMin   = sizeof(T) < sizeof(void*) ? sizeof(void*) : sizeof(T);
+    static constexpr size_t kSize  = (kMin + kAlign - 1) / kAlign * kAlign;
+    static BlockPool& Pool() { return BlockPool::For<kSize, kAlign>(); }
+};
@@ -0,0 +1,108 @@
+// ================== bootstrap/JobSystem.cpp ==================
+#include "bootstrap/JobSystem.h"
+#include "core/logging/Logging.h"
+#include <algorithm>
+
+// Upper bound on pool threads, whatever the machine reports
+static constexpr unsigned kMaxWorkers = 31;
+
+// -1 outside jobs; worker index while running inside ParallelFor
+static thread_local int tlsWorker = -1;
+
+JobSystem& JobSystem::Get() {
+    static JobSystem js;
+    return js;
+}
+
+JobSystem::JobSystem() {
+    const unsigned hw = std::thread::hardware_concurrency();
+    const unsigned n = std::min(kMaxWorkers, hw > 1 ? hw - 1 : 0u);
+    threads.reserve(n);
+    for (unsigned i = 0; i < n; ++i)
+        threads.emplace_back([this, i]{ WorkerMain((int)i + 1); });
+    LOGI("JobSystem: %u worker threads", n);
+}
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+void JobSystem::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lk(m);
+        if (quit) return;
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads) if (t.joinable()) t.join();
+    threads.clear();
+}
+
+void JobSystem::RunChunks(int worker, const RangeFn& fn, size_t count, size_t grain) {
+    const size_t chunks = (count + grain - 1) / grain;
+    for (;;) {
+        const size_t c = nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (c >= chunks) break;
+        const size_t begin = c * grain;
+        const size_t end = std::min(count, begin + grain);
+        fn(begin, end, worker);
+        chunksLeft.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+void JobSystem::WorkerMain(int worker) {
+    tlsWorker = worker;
+    uint64_t seen = 0;
+    for (;;) {
+        const RangeFn* fn;
+        size_t count, grain;
+        {
+            std::unique_lock<std::mutex> lk(m);
+            wake.wait(lk, [&]{ return quit || generation != seen; });
+            if (quit) return;
+            seen = generation;
+            if (!job) continue;   // woke too late, that job already finished
+            fn = job; count = jobCount; grain = jobGrain;
+            busyWorkers++;
+        }
+        RunChunks(worker, *fn, count, grain);
+        {
+            std::lock_guard<std::mutex> lk(m);
+            busyWorkers--;
+        }
+        done.notify_one();
+    }
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grain, const RangeFn& fn) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+
+    // inline: no pool, a single chunk, or already inside a job
+    if (threads.empty() || count <= grain || tlsWorker >= 0) {
+        fn(0, count, tlsWorker >= 0 ? tlsWorker : 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submitMutex);
+    const size_t chunks = (count + grain - 1) / grain;
+    {
+        std::lock_guard<std::mutex> lk(m);
+        job = &fn;
+        jobCount = count;
+        jobGrain = grain;
+        nextChunk.store(0, std::memory_order_relaxed);
+        chunksLeft.store(chunks, std::memory_order_relaxed);
+        generation++;
+    }
+    wake.notify_all();
+
+    tlsWorker = 0;
+    RunChunks(0, fn, count, grain);
+    tlsWorker = -1;
+
+    // wait for stragglers, and for every worker to leave RunChunks before 'fn' goes away
+    std::unique_lock<std::mutex> lk(m);
+    done.wait(lk, [&]{ return chunksLeft.load(std::memory_order_acquire) == 0 && busyWorkers == 0; });
+    job = nullptr;
+}
@@ -0,0 +1,58 @@
+// ================== bootstrap/JobSystem.h ==================
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fork/join worker pool for data-parallel engine work (render list
+// extraction, matrix rebuilds, actor VMs). Jobs must not touch GL, and may only
+// enter a Lua VM that no other job is using.
+class JobSystem {
+public:
+    // fn(begin, end, worker): worker is 0 for the calling thread, 1..N for pool threads
+    using RangeFn = std::function<void(size_t begin, size_t end, int worker)>;
+
+    static JobSystem& Get();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    ~JobSystem();
+
+    // Threads that can run a job at once (pool + caller); size per-worker outputs with this
+    int WorkerCount() const { return (int)threads.size() + 1; }
+
+    // Split [0, count) into chunks of 'grain' and run them across the pool. The
+    // caller helps and returns once every chunk is done. Nested calls from inside
+    // a job, or ranges of a single chunk, just run inline.
+    void ParallelFor(size_t count, size_t grain, const RangeFn& fn);
+
+    // Joins the pool; later ParallelFor calls run inline
+    void Shutdown();
+
+private:
+    JobSystem();
+    void WorkerMain(int worker);
+    void RunChunks(int worker, const RangeFn& fn, size_t count, size_t grain);
+
+    std::vector<std::thread> threads;
+    std::mutex              submitMutex;   // one ParallelFor at a time
+    std::mutex              m;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t                generation{0};
+    bool                    quit{false};
+
+    // current job
+    const RangeFn*      job{nullptr};
+    size_t              jobCount{0};
+    size_t              jobGrain{1};
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<size_t> chunksLeft{0};
+    int                 busyWorkers{0};
+};
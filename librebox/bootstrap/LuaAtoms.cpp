@@ -0,0 +1,31 @@
+// ================== bootstrap/LuaAtoms.cpp ==================
+#include "bootstrap/LuaAtoms.h"
+#include "lua.h"
+#include <string_view>
+#include <unordered_map>
+
+static const char* const kAtomNames[Atom_Count] = {
+#define LB_ATOM_NAME(n) #n,
+    LB_LUA_ATOMS(LB_ATOM_NAME)
+#undef LB_ATOM_NAME
+};
+
+int16_t LuaAtomOf(const char* s, size_t len) {
+    static const std::unordered_map<std::string_view, int16_t> byName = []{
+        std::unordered_map<std::string_view, int16_t> m;
+        for (int i = 0; i < Atom_Count; ++i) m.emplace(kAtomNames[i], (int16_t)i);
+        return m;
+    }();
+    auto it = byName.find(std::string_view(s, len));
+    return it == byName.end() ? (int16_t)Atom_None : it->second;
+}
+
+const char* LuaAtomName(int atom) {
+    return (atom >= 0 && atom < Atom_Count) ? kAtomNames[atom] : "";
+}
+
+int Lua_ToAtom(lua_State* L, int idx) {
+    int atom = Atom_None;
+    if (!lua_tostringatom(L, idx, &atom)) return Atom_None;
+    return atom;
+}
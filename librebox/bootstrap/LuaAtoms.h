@@ -0,0 +1,51 @@
+// ================== bootstrap/LuaAtoms.h ==================
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+struct lua_State;
+
+// Every property and method name the engine dispatches on. Luau asks
+// LuaAtomOf() once per interned string, so __index/__newindex/__namecall
+// switch on a small integer instead of comparing strings.
+#define LB_LUA_ATOMS(X)                                                          \
+    /* Instance */                                                               \
+    X(Name) X(ClassName) X(Parent)                                               \
+    X(SetAttribute) X(GetAttribute) X(GetAttributes) X(GetFullName) X(Destroy)   \
+    X(GetChildren) X(GetDescendants) X(FindFirstChild) X(FindFirstChildOfClass)  \
+    X(FindFirstChildWhichIsA) X(FindFirstAncestor) X(FindFirstAncestorOfClass)   \
+    X(FindFirstAncestorWhichIsA) X(IsDescendantOf) X(IsAncestorOf)               \
+    X(ClearAllChildren) X(Clone) X(IsA) X(QueryDescendants)                      \
+    X(AddTag) X(RemoveTag) X(HasTag) X(GetTags)                                  \
+    /* legacy spellings */                                                       \
+    X(getChildren) X(clone) X(Remove) X(remove) X(findFirstChild) X(isDescendantOf) \
+    /* BasePart */                                                               \
+    X(CFrame) X(Position) X(Orientation) X(Size) X(Transparency) X(CastShadow) X(Color) \
+    X(Anchored) X(CanCollide) X(CanTouch) X(Reflectance)                         \
+    X(Density) X(Friction) X(Elasticity)                                         \
+    /* Lighting */                                                               \
+    X(ClockTime) X(Brightness) X(Ambient)                                        \
+    /* RunService */                                                             \
+    X(PreRender) X(PreAnimation) X(PreSimulation) X(PostSimulation) X(Heartbeat) \
+    X(RenderStepped) X(Stepped)                                                  \
+    /* Game */                                                                   \
+    X(GetService) X(FindService)                                                 \
+    /* Workspace */                                                              \
+    X(BulkMoveTo) X(BulkParent)                                                  \
+    /* CollectionService */                                                      \
+    X(GetTagged) X(GetInstanceAddedSignal) X(GetInstanceRemovedSignal)
+
+enum LuaAtom : int16_t {
+    Atom_None = -1,   // not an engine name (e.g. a child's name)
+#define LB_ATOM_ENUM(n) Atom_##n,
+    LB_LUA_ATOMS(LB_ATOM_ENUM)
+#undef LB_ATOM_ENUM
+    Atom_Count
+};
+
+// lua_Callbacks::useratom; Atom_None for names the engine does not know
+int16_t LuaAtomOf(const char* s, size_t len);
+const char* LuaAtomName(int atom);
+
+// Atom of the string at 'idx' (Atom_None if it is not a string)
+int Lua_ToAtom(lua_State* L, int idx);
@@ -1,11 +1,17 @@
 // ================== bootstrap/LuaScheduler.cpp ==================
 #include "bootstrap/LuaScheduler.h"
+#include "bootstrap/JobSystem.h"
+#include "bootstrap/ScriptingAPI.h"
+#include "bootstrap/signals/Signal.h"
 #include "bootstrap/instances/BaseScript.h"
+#include "core/datatypes/Vector3Game.h"
 #include "core/logging/Logging.h"
 
 #include <cstdlib>
 #include <limits>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 
 // Raylib time
@@ -17,9 +23,35 @@
 #include "luacode.h"
 #include <limits>
 
+#ifdef LB_CODEGEN
+#include "Luau/CodeGen.h"
+#endif
+
+// Consecutive frames a lane may leave work behind before it is reported
+static constexpr int kStarvationWarnFrames = 60;
+
+static bool gNativeAll = false;
+static std::string gBytecodeCacheDir;
+
+// Set on whichever thread is running an actor's parallel phase
+static thread_local bool tlParallelPhase = false;
+
+bool LuaScheduler::InParallelPhase() { return tlParallelPhase; }
+
+LuaScheduler* LuaScheduler::From(lua_State* L) {
+    return static_cast<LuaScheduler*>(lua_callbacks(L)->userdata);
+}
+
+void LuaScheduler::SetNativeCodegen(bool all) { gNativeAll = all; }
+void LuaScheduler::SetBytecodeCacheDir(const std::string& dir) { gBytecodeCacheDir = dir; }
+
+// Engine userdata type names for the compiler's type info, so annotated
+// arguments and locals reach CodeGen as userdata rather than unknown values.
+// Vector3 is a native vector type when that mode is on.
+static const char* const kUserdataTypes[]       = { "Vector3", "CFrame", "Color3", "Instance", nullptr };
+static const char* const kUserdataTypesNoVec3[] = { "CFrame", "Color3", "Instance", nullptr };
+
 LuaScheduler::LuaScheduler()
-    : sleepingByTime(TimeCmp{&state})
-    , sleepingTasks(TaskTimeCmp{&tasks})
 {
     LOGI("LuaScheduler: Initializing...");
     L_main = luaL_newstate();
@@ -28,31 +60,61 @@ LuaScheduler::LuaScheduler()
         return;
     }
     luaL_openlibs(L_main);
+    lua_callbacks(L_main)->userdata = this;
+
+#ifdef LB_CODEGEN
+    if (Luau::CodeGen::isSupported()) {
+        Luau::CodeGen::create(L_main);
+        codegen = true;
+        LOGI("LuaScheduler: native codegen enabled (%s)", gNativeAll ? "all scripts" : "--!native scripts");
+    } else {
+        LOGW("LuaScheduler: native codegen is not supported on this platform");
+    }
+#endif
 
-    lua_gc(L_main, LUA_GCSETGOAL,     200);
+    for (int& ref : stashRef) {
+        lua_newtable(L_main);
+        ref = lua_ref(L_main, -1);
+        lua_pop(L_main, 1);
+    }
+
+    lua_gc(L_main, LUA_GCSETGOAL,     gcPacing.goal);
     lua_gc(L_main, LUA_GCSETSTEPMUL,  200);
     lua_gc(L_main, LUA_GCSETSTEPSIZE, 128);
+
+    bytecodeCache.SetDirectory(gBytecodeCacheDir);
 }
 
 LuaScheduler::~LuaScheduler() {
     LOGI("LuaScheduler: Shutting down...");
-    while (!sleepingByTime.empty()) sleepingByTime.pop();
-    while (!sleepingTasks.empty()) sleepingTasks.pop();
-    ready.clear();
-    nextFrameQ.clear();
-    readyTasks.clear();
-    nextFrameTasks.clear();
+    if (!isActor) {
+        LOGI("LuaScheduler: bytecode cache %zu hits (%zu from disk), %zu compiled",
+             bytecodeCache.hits + bytecodeCache.diskHits, bytecodeCache.diskHits, bytecodeCache.misses);
+        LOGI("LuaScheduler: %zu threads created, %zu pooled", threadsCreated, threadPool.size());
+    }
+    actors.clear();
+    sleepingByTime.Clear();
+    sleepingTasks.Clear();
+    for (auto& q : ready) q.Reset();
+    parallelReady.Reset();
+    nextFrameQ.Reset();
+    readyTasks.Reset();
+    parallelTasks.Reset();
+    nextFrameTasks.Reset();
+    for (auto& q : dispatchQueue) q.clear();
     // Unref any remaining task threads
     if (L_main) {
-        for (auto& kv : tasks) {
-            if (kv.second.registryRef != LUA_NOREF) {
-                lua_unref(L_main, kv.second.registryRef);
+        for (uint32_t i = 0; i < tasks.Capacity(); ++i) {
+            if (!tasks.Live(i)) continue;
+            TaskState& st = tasks.At(i);
+            if (st.registryRef != LUA_NOREF) {
+                lua_unref(L_main, st.registryRef);
             }
-            kv.second.registryRef = LUA_NOREF;
+            st.registryRef = LUA_NOREF;
         }
     }
-    tasks.clear();
-    state.clear();
+    taskByThread.clear();
+    scriptByOwner.clear();
     if (L_main) {
         lua_close(L_main);
         L_main = nullptr;
@@ -64,64 +126,146 @@ LuaScheduler::~LuaScheduler() {
 int pendingArgc = 0;
 bool hasPending = false;
 
-// GetScriptThread
-lua_State* LuaScheduler::GetScriptThread(BaseScript* s) {
-    auto it = state.find(s); return it==state.end() ? nullptr : it->second.co;
+// ======= Records =======
+
+LuaScheduler::ScriptState* LuaScheduler::FindScript(BaseScript* s) {
+    auto it = scriptByOwner.find(s);
+    return it == scriptByOwner.end() ? nullptr : scripts.Get(it->second);
 }
 
-void LuaScheduler::SetWaitEvent(BaseScript* s){
-    auto it = state.find(s); if (it==state.end()) return;
-    auto& st = it->second;
-    st.status    = Status::Waiting;
-    st.nextFrame = false;
-    st.wakeTime  = std::numeric_limits<double>::infinity(); // parked
+LuaScheduler::TaskState* LuaScheduler::FindTask(lua_State* co) {
+    auto it = taskByThread.find(co);
+    return it == taskByThread.end() ? nullptr : tasks.Get(it->second);
 }
 
-void LuaScheduler::SetTaskWaitEvent(lua_State* co){
-    auto it = tasks.find(co); if (it==tasks.end()) return;
-    auto& st = it->second;
-    st.status    = Status::Waiting;
-    st.nextFrame = false;
-    st.wakeTime  = std::numeric_limits<double>::infinity();
+LuaScheduler::TaskState* LuaScheduler::FindOrAdoptTask(lua_State* co) {
+    if (TaskState* st = FindTask(co)) return st;
+    if (!co || co != dispatching.co) return nullptr;
+    // a listener is about to wait: from here on it is an ordinary task that
+    // owns its thread, and the pool gets a fresh one
+    TaskState& st = AcquireTask(co);
+    st.status      = Status::Running;
+    st.registryRef = dispatching.ref;
+    st.pooledThread = true;
+    st.firstResume = false;
+    st.parallel    = InParallelPhase();
+    return &st;
 }
 
-void LuaScheduler::ResumeScriptNextFrame(BaseScript* s, int argc){
-    auto it = state.find(s); if (it==state.end()) return;
-    auto& st = it->second;
-    st.status     = Status::Running;
-    st.nextFrame  = true;
-    st.pendingArgc = argc;
-    st.hasPending = true;
-    nextFrameQ.push_back(st.co ? std::static_pointer_cast<BaseScript>(s->shared_from_this()) : nullptr);
+LuaScheduler::TaskState& LuaScheduler::AcquireTask(lua_State* co) {
+    if (TaskState* st = FindTask(co)) {
+        UnlinkTask(*st);
+        return *st;
+    }
+    const Handle h = tasks.Create();
+    TaskState& st = *tasks.Get(h);
+    st.slot = h.index;
+    st.co   = co;
+    taskByThread[co] = h;
+    return st;
 }
 
-void LuaScheduler::WakeTaskNextFrame(lua_State* co, int argc){
-    auto it = tasks.find(co); if (it == tasks.end()) return;
-    auto& st = it->second;
-    st.status      = Status::Running;
-    st.nextFrame   = true;
-    st.pendingArgc = argc;
-    st.hasPending  = true; 
-    nextFrameTasks.push_back(co);
+void LuaScheduler::UnlinkScript(ScriptState& st) {
+    ready[st.lane].Remove(scripts, st.slot);
+    parallelReady.Remove(scripts, st.slot);
+    nextFrameQ.Remove(scripts, st.slot);
+    sleepingByTime.Cancel(&st);
 }
 
-void LuaScheduler::AddScript(const std::shared_ptr<BaseScript>& script,
-                             const std::string&                 name,
-                             const std::string&                 source,
-                             const GlobalBinder&                binder)
-{
-    if (!L_main || !script) return;
+void LuaScheduler::UnlinkTask(TaskState& st) {
+    readyTasks.Remove(tasks, st.slot);
+    parallelTasks.Remove(tasks, st.slot);
+    nextFrameTasks.Remove(tasks, st.slot);
+    sleepingTasks.Cancel(&st);
+}
 
-    lua_State* co = lua_newthread(L_main);
-    if (!co) {
-        LOGE("LuaScheduler: lua_newthread failed for '%s'", name.c_str());
-        return;
+void LuaScheduler::MakeReady(ScriptState& st) {
+    if (st.parallel) parallelReady.PushBack(scripts, st.slot);
+    else             ready[st.lane].PushBack(scripts, st.slot);
+}
+
+void LuaScheduler::MakeReady(TaskState& st) {
+    if (st.parallel) parallelTasks.PushBack(tasks, st.slot);
+    else             readyTasks.PushBack(tasks, st.slot);
+}
+
+void LuaScheduler::Requeue(ScriptState& st) {
+    if (st.parallel != InParallelPhase()) MakeReady(st);   // same frame, other phase
+    else nextFrameQ.PushBack(scripts, st.slot);
+}
+
+void LuaScheduler::Requeue(TaskState& st) {
+    if (st.parallel != InParallelPhase()) MakeReady(st);
+    else nextFrameTasks.PushBack(tasks, st.slot);
+}
+
+bool LuaScheduler::SetThreadParallel(BaseScript* self, lua_State* co, bool parallel) {
+    if (self) {
+        ScriptState* st = FindScript(self);
+        if (!st) return false;
+        st->parallel = parallel;
+        return true;
     }
+    TaskState* st = FindOrAdoptTask(co);
+    if (!st) return false;
+    st->parallel = parallel;
+    return true;
+}
 
-    lua_setthreaddata(co, script.get());
-    luaL_sandboxthread(co);
+void LuaScheduler::DestroyTask(TaskState& st) {
+    UnlinkTask(st);
+    taskByThread.erase(st.co);
+    tasks.Destroy(tasks.HandleAt(st.slot));
+}
+
+lua_State* LuaScheduler::GetScriptThread(Handle h) {
+    ScriptState* st = scripts.Get(h);
+    return st ? st->co : nullptr;
+}
+
+lua_State* LuaScheduler::GetTaskThread(Handle h) {
+    TaskState* st = tasks.Get(h);
+    return st ? st->co : nullptr;
+}
+
+LuaScheduler::Handle LuaScheduler::SetWaitEvent(BaseScript* s){
+    auto it = scriptByOwner.find(s); if (it==scriptByOwner.end()) return {};
+    ScriptState* st = scripts.Get(it->second); if (!st) return {};
+    st->status    = Status::Waiting;
+    st->nextFrame = false;
+    st->wakeTime  = std::numeric_limits<double>::infinity(); // parked
+    return it->second;
+}
+
+LuaScheduler::Handle LuaScheduler::SetTaskWaitEvent(lua_State* co){
+    TaskState* st = FindOrAdoptTask(co); if (!st) return {};
+    st->status    = Status::Waiting;
+    st->nextFrame = false;
+    st->wakeTime  = std::numeric_limits<double>::infinity();
+    return tasks.HandleAt(st->slot);
+}
+
+void LuaScheduler::ResumeScriptNextFrame(Handle h, int argc){
+    ScriptState* st = scripts.Get(h); if (!st) return;
+    UnlinkScript(*st);
+    st->status      = Status::Running;
+    st->nextFrame   = true;
+    st->pendingArgc = argc;
+    st->hasPending  = true;
+    nextFrameQ.PushBack(scripts, st->slot);
+}
+
+void LuaScheduler::WakeTaskNextFrame(Handle h, int argc){
+    TaskState* st = tasks.Get(h); if (!st) return;
+    UnlinkTask(*st);
+    st->status      = Status::Running;
+    st->nextFrame   = true;
+    st->pendingArgc = argc;
+    st->hasPending  = true;
+    nextFrameTasks.PushBack(tasks, st->slot);
+}
 
-    size_t bcSize = 0;
+bool LuaScheduler::LoadChunk(lua_State* co, const std::string& name, const std::string& source) {
     lua_CompileOptions opts{};
     opts.optimizationLevel = 1;
     opts.debugLevel        = 1;
@@ -131,74 +275,146 @@ void LuaScheduler::AddScript(const std::shared_ptr<BaseScript>& script,
     };
     opts.mutableGlobals = kMutable;  // NULL-terminated
 
-    char* bytecode = luau_compile(source.c_str(), source.size(), &opts, &bcSize);
-    if (!bytecode || bcSize == 0) {
-        LOGE("Luau Compile Error for '%s'", name.c_str());
-        if (bytecode) free(bytecode);
-        return;
+    // type info guides native codegen; without --native only --!native modules get it
+    opts.typeInfoLevel = gNativeAll ? 1 : 0;
+    opts.userdataTypes = lb::NativeVector3() ? kUserdataTypesNoVec3 : kUserdataTypes;
+    if (lb::NativeVector3()) {
+        // Vector3.new() becomes the vector builtin and ': Vector3' a vector type
+        opts.vectorLib  = "Vector3";
+        opts.vectorCtor = "new";
+        opts.vectorType = "Vector3";
     }
 
+    const BytecodeCache::Key key = BytecodeCache::MakeKey(source, opts);
     const std::string chunkName = "@" + name;
-    if (luau_load(co, chunkName.c_str(), bytecode, bcSize, 0) != 0) {
-        LOGE("Luau Load Error for '%s': %s", name.c_str(), lua_tostring(co, -1));
-        lua_pop(co, 1);
-        free(bytecode);
+
+    auto it = protoRefs.find({key, chunkName});
+    if (it == protoRefs.end()) {
+        BytecodeCache& cache = owner ? owner->bytecodeCache : bytecodeCache;
+        const std::string* bc = cache.Find(key);
+        if (!bc) {
+            size_t bcSize = 0;
+            char* bytecode = luau_compile(source.c_str(), source.size(), &opts, &bcSize);
+            if (!bytecode || bcSize == 0) {
+                LOGE("Luau Compile Error for '%s'", name.c_str());
+                if (bytecode) free(bytecode);
+                return false;
+            }
+            bc = &cache.Store(key, std::string(bytecode, bcSize));
+            free(bytecode);
+        }
+
+        // The loaded function stays on L_main as a template and is never run;
+        // scripts get clones bound to their own sandboxed globals.
+        if (luau_load(L_main, chunkName.c_str(), bc->data(), bc->size(), 0) != 0) {
+            LOGE("Luau Load Error for '%s': %s", name.c_str(), lua_tostring(L_main, -1));
+            lua_pop(L_main, 1);
+            return false;
+        }
+
+#ifdef LB_CODEGEN
+        if (codegen) {
+            Luau::CodeGen::CompilationOptions cg;
+            cg.flags = gNativeAll ? 0 : Luau::CodeGen::CodeGen_OnlyNativeModules;
+            const Luau::CodeGen::CompilationResult res = Luau::CodeGen::compile(L_main, -1, cg);
+            if (res.result != Luau::CodeGen::CodeGenCompilationResult::Success &&
+                res.result != Luau::CodeGen::CodeGenCompilationResult::NothingToCompile &&
+                res.result != Luau::CodeGen::CodeGenCompilationResult::NotNativeModule) {
+                LOGW("Native codegen failed for '%s': %s", name.c_str(),
+                     Luau::CodeGen::toString(res.result).c_str());
+            }
+            for (const auto& f : res.protoFailures) {
+                LOGW("Native codegen skipped %s:%d in '%s': %s", f.debugname.c_str(), f.line,
+                     name.c_str(), Luau::CodeGen::toString(f.result).c_str());
+            }
+        }
+#endif
+
+        it = protoRefs.emplace(std::make_pair(key, chunkName), lua_ref(L_main, -1)).first;
+        lua_pop(L_main, 1);
+    }
+
+    lua_getref(co, it->second);
+    lua_clonefunction(co, -1);   // takes co's globals as its environment
+    lua_remove(co, -2);
+    return true;
+}
+
+void LuaScheduler::AddScript(const std::shared_ptr<BaseScript>& script,
+                             const std::string&                 name,
+                             const std::string&                 source,
+                             const GlobalBinder&                binder)
+{
+    if (!L_main || !script) return;
+
+    lua_State* co = lua_newthread(L_main);
+    if (!co) {
+        LOGE("LuaScheduler: lua_newthread failed for '%s'", name.c_str());
         return;
     }
-    free(bytecode);
+
+    lua_setthreaddata(co, script.get());
+    luaL_sandboxthread(co);
+
+    if (!LoadChunk(co, name, source)) return;
 
     if (binder) binder(co, script.get());
 
-    auto& st = state[script.get()];
+    StopScript(script.get());   // scheduling again replaces the previous run
+    const Handle h = scripts.Create();
+    ScriptState& st = *scripts.Get(h);
     st.status       = Status::Running;
+    st.script       = script.get();
     st.co           = co;
-    st.wakeTime     = 0.0;
-    st.nextFrame    = false;
     st.lastResumeTime = GetTime();
-    st.passDelta    = false;
-    st.resumeDelta  = 0.0;
-    st.firstResume  = true;
+    st.slot         = h.index;
+    switch (script->GetRunContext()) {
+    case RunContext::Server: st.lane = Lane_Server; break;
+    case RunContext::Client: st.lane = Lane_Client; break;
+    case RunContext::Plugin: st.lane = Lane_Plugin; break;
+    }
+    scriptByOwner[script.get()] = h;
 
-    ready.push_back(script);
+    ready[st.lane].PushBack(scripts, st.slot);
 }
 
 void LuaScheduler::StopScript(BaseScript* s) {
     if (!s) return;
 
-    // Drop state so the coroutine will never be resumed again.
-    auto it = state.find(s);
-    if (it != state.end()) state.erase(it);
-
-    // Purge from ready/nextFrame queues.
-    auto pred = [s](const std::shared_ptr<BaseScript>& sp){ return sp.get() == s; };
-    ready.erase(std::remove_if(ready.begin(), ready.end(), pred), ready.end());
-    nextFrameQ.erase(std::remove_if(nextFrameQ.begin(), nextFrameQ.end(), pred), nextFrameQ.end());
+    // Drop the record so the coroutine will never be resumed again.
+    auto it = scriptByOwner.find(s);
+    if (it == scriptByOwner.end()) {
+        for (auto& a : actors) a.sched->StopScript(s);
+        return;
+    }
+    if (ScriptState* st = scripts.Get(it->second)) {
+        UnlinkScript(*st);
+        scripts.Destroy(it->second);
+    }
+    scriptByOwner.erase(it);
 }
 
 void LuaScheduler::SetWaitAbs(BaseScript* s, double wakeTimeAbs) {
-    auto it = state.find(s);
-    if (it == state.end()) return;
-    auto& st = it->second;
-    st.status    = Status::Waiting;
-    st.nextFrame = false;
-    st.wakeTime  = wakeTimeAbs;
+    ScriptState* st = FindScript(s);
+    if (!st) return;
+    st->status    = Status::Waiting;
+    st->nextFrame = false;
+    st->wakeTime  = wakeTimeAbs;
 }
 
 void LuaScheduler::SetWaitNextFrame(BaseScript* s) {
-    auto it = state.find(s);
-    if (it == state.end()) return;
-    auto& st = it->second;
-    st.status    = Status::Waiting;
-    st.nextFrame = true;
+    ScriptState* st = FindScript(s);
+    if (!st) return;
+    st->status    = Status::Waiting;
+    st->nextFrame = true;
 }
 
 // ======= Task API =======
 
 void LuaScheduler::ScheduleTaskNextFrame(lua_State* co, int registryRef, int initialArgc) {
     if (!L_main || !co) return;
-    auto& st = tasks[co];
+    TaskState& st = AcquireTask(co);
     st.status       = Status::Waiting;
-    st.co           = co;
     st.registryRef  = registryRef;
     st.nextFrame    = true;
     st.wakeTime     = 0.0;
@@ -207,14 +423,13 @@ void LuaScheduler::ScheduleTaskNextFrame(lua_State* co, int registryRef, int ini
     st.resumeDelta  = 0.0;
     st.firstResume  = true;
     st.pendingArgc  = initialArgc;
-    nextFrameTasks.push_back(co);
+    nextFrameTasks.PushBack(tasks, st.slot);
 }
 
 void LuaScheduler::ScheduleTaskAt(lua_State* co, int registryRef, double wakeTimeAbs, int initialArgc) {
     if (!L_main || !co) return;
-    auto& st = tasks[co];
+    TaskState& st = AcquireTask(co);
     st.status       = Status::Waiting;
-    st.co           = co;
     st.registryRef  = registryRef;
     st.nextFrame    = false;
     st.wakeTime     = wakeTimeAbs;
@@ -223,231 +438,567 @@ void LuaScheduler::ScheduleTaskAt(lua_State* co, int registryRef, double wakeTim
     st.resumeDelta  = 0.0;
     st.firstResume  = true;
     st.pendingArgc  = initialArgc;
-    sleepingTasks.push(co);
+    sleepingTasks.Schedule(&st, wakeTimeAbs);
 }
 
 void LuaScheduler::SetTaskWaitAbs(lua_State* co, double wakeTimeAbs) {
-    auto it = tasks.find(co);
-    if (it == tasks.end()) return;
-    auto& st = it->second;
-    st.status    = Status::Waiting;
-    st.nextFrame = false;
-    st.wakeTime  = wakeTimeAbs;
+    TaskState* st = FindOrAdoptTask(co);
+    if (!st) return;
+    st->status    = Status::Waiting;
+    st->nextFrame = false;
+    st->wakeTime  = wakeTimeAbs;
 }
 
 void LuaScheduler::SetTaskWaitNextFrame(lua_State* co) {
-    auto it = tasks.find(co);
-    if (it == tasks.end()) return;
-    auto& st = it->second;
-    st.status    = Status::Waiting;
-    st.nextFrame = true;
+    TaskState* st = FindOrAdoptTask(co);
+    if (!st) return;
+    st->status    = Status::Waiting;
+    st->nextFrame = true;
 }
 
 // ======= Step =======
-void LuaScheduler::Step(double now, double /*dt*/) {
+void LuaScheduler::Step(double now, double dt) {
     if (!L_main) return;
     frameIndex++;
 
-    lua_gc(L_main, LUA_GCSTEP, 200);
-
     // Wake timed script sleepers
-    while (!sleepingByTime.empty()) {
-        auto s = sleepingByTime.top();
-        auto it = state.find(s.get());
-        if (it == state.end()) { sleepingByTime.pop(); continue; }
-        auto& st = it->second;
-
-        if (st.status != Status::Waiting || st.nextFrame) {
-            sleepingByTime.pop();
-            ready.push_back(s);
-            continue;
-        }
-        if (st.wakeTime > now) break;
-
-        sleepingByTime.pop();
+    while (!sleepingByTime.Empty() && sleepingByTime.TopTime() <= now) {
+        ScriptState& st = *sleepingByTime.Pop();
         st.status      = Status::Running;
         st.nextFrame   = false;
         st.passDelta   = true;
         st.resumeDelta = now - st.lastResumeTime;
-        ready.push_back(std::move(s));
+        MakeReady(st);
     }
 
     // Wake timed TASK sleepers
-    while (!sleepingTasks.empty()) {
-        lua_State* co = sleepingTasks.top();
-        auto it = tasks.find(co);
-        if (it == tasks.end()) { sleepingTasks.pop(); continue; }
-        auto& st = it->second;
-
-        if (st.status != Status::Waiting || st.nextFrame) {
-            sleepingTasks.pop();
-            readyTasks.push_back(co);
-            continue;
-        }
-        if (st.wakeTime > now) break;
-
-        sleepingTasks.pop();
+    while (!sleepingTasks.Empty() && sleepingTasks.TopTime() <= now) {
+        TaskState& st = *sleepingTasks.Pop();
         st.status      = Status::Running;
         st.nextFrame   = false;
         st.passDelta   = true;
         st.resumeDelta = now - st.lastResumeTime;
-        readyTasks.push_back(co);
+        MakeReady(st);
     }
 
     // Move next-frame scripts
-    if (!nextFrameQ.empty()) {
-        for (auto& s : nextFrameQ) {
-            auto it = state.find(s.get());
-            if (it == state.end()) continue;
-            auto& st = it->second;
-            st.status      = Status::Running;
-            st.nextFrame   = false;
-            st.passDelta   = true;
-            st.resumeDelta = now - st.lastResumeTime;
-            ready.push_back(std::move(s));
-        }
-        nextFrameQ.clear();
+    while (!nextFrameQ.Empty()) {
+        ScriptState& st = scripts.At(nextFrameQ.PopFront(scripts));
+        st.status      = Status::Running;
+        st.nextFrame   = false;
+        st.passDelta   = true;
+        st.resumeDelta = now - st.lastResumeTime;
+        MakeReady(st);
     }
 
     // Move next-frame tasks
-    if (!nextFrameTasks.empty()) {
-        for (auto co : nextFrameTasks) {
-            auto it = tasks.find(co);
-            if (it == tasks.end()) continue;
-            auto& st = it->second;
-            st.status      = Status::Running;
-            st.nextFrame   = false;
-            st.resumeDelta = now - st.lastResumeTime;
-            readyTasks.push_back(co);
+    while (!nextFrameTasks.Empty()) {
+        TaskState& st = tasks.At(nextFrameTasks.PopFront(tasks));
+        st.status      = Status::Running;
+        st.nextFrame   = false;
+        st.resumeDelta = now - st.lastResumeTime;
+        MakeReady(st);
+    }
+
+    FrameStats& fs = frameStats;
+    fs = FrameStats{};
+    for (int lane = 0; lane < Lane_Tasks; ++lane) fs.readyDepth[lane] = ready[lane].Size();
+    fs.readyDepth[Lane_Tasks] = readyTasks.Size();
+    fs.dispatched = immediateDispatched;   // run inside Fire() since the last Step
+    immediateDispatched = 0;
+
+    // Listeners of signals fired since the last Step. They always run; their
+    // time still counts against the budget left for the lanes.
+    if (!dispatchQueue[0].empty()) {
+        const auto t0 = std::chrono::steady_clock::now();
+        fs.dispatched += DrainDispatch(0, now);
+        fs.resumeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    auto laneEmpty = [this](int lane) {
+        return lane == Lane_Tasks ? readyTasks.Empty() : ready[lane].Empty();
+    };
+
+    // Lanes take turns until every lane is drained or the frame budget is spent.
+    // Each resume is timed; the budget counts time spent inside Luau only.
+    const double budget = (maxTimeBudgetSeconds > 0.0)
+                        ? maxTimeBudgetSeconds
+                        : std::numeric_limits<double>::infinity();
+    bool progressed = true;
+    while (progressed && !fs.budgetExhausted) {
+        progressed = false;
+        for (int lane = 0; lane < Lane_Count && !fs.budgetExhausted; ++lane) {
+            const int quota = (resumePolicy == ResumePolicy::Fair)
+                            ? std::max(1, laneWeights[lane])
+                            : std::numeric_limits<int>::max();
+            for (int n = 0; n < quota && !laneEmpty(lane); ) {
+                if (fs.resumes >= maxResumesPerFrame || fs.resumeSeconds >= budget) {
+                    fs.budgetExhausted = true;
+                    break;
+                }
+                const auto t0 = std::chrono::steady_clock::now();
+                const bool resumed = (lane == Lane_Tasks)
+                                   ? ResumeTask(readyTasks.PopFront(tasks), now)
+                                   : ResumeScript(ready[lane].PopFront(scripts), now);
+                progressed = true;
+                if (!resumed) continue;
+                const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                fs.resumes++;
+                fs.laneResumes[lane]++;
+                fs.resumeSeconds += secs;
+                fs.worstResumeSeconds = std::max(fs.worstResumeSeconds, secs);
+                n++;
+            }
         }
-        nextFrameTasks.clear();
     }
 
-    const double deadline = (maxTimeBudgetSeconds > 0.0)
-                          ? (now + maxTimeBudgetSeconds)
-                          : std::numeric_limits<double>::infinity();
+    fs.sleeping = sleepingByTime.Size() + sleepingTasks.Size();
+
+    // Work left in a lane is resumed next frame; say so when a lane keeps losing
+    static const char* const kLaneNames[Lane_Count] = { "server script", "client script", "plugin script", "task" };
+    for (int lane = 0; lane < Lane_Count; ++lane) {
+        fs.deferred[lane] = (lane == Lane_Tasks) ? readyTasks.Size() : ready[lane].Size();
+        if (fs.deferred[lane] == 0) { starvedFrames[lane] = 0; continue; }
+        const int frames = ++starvedFrames[lane];
+        if (frames == kStarvationWarnFrames || frames % (kStarvationWarnFrames * 10) == 0) {
+            LOGW("LuaScheduler: %s lane deferred work for %d frames (%zu waiting, worst resume %.2f ms)",
+                 kLaneNames[lane], frames, fs.deferred[lane], fs.worstResumeSeconds * 1000.0);
+        }
+    }
+
+    if (actors.empty()) return;
+
+    // Actor VMs: serial phase here, on the main thread, then the parallel phase.
+    // Indices, not iterators: scripts may schedule into new actors meanwhile.
+    for (size_t i = 0; i < actors.size(); ++i) {
+        if (!actors[i].released) actors[i].sched->Step(now, dt);
+    }
+    RunActorsParallel(now);
+
+    // Closing a VM can drop the last reference to another Actor, whose
+    // destructor calls ReleaseActor; close them only once 'actors' is settled
+    std::vector<ActorVM> closing;
+    for (auto& a : actors) if (a.released) closing.push_back(std::move(a));
+    if (!closing.empty()) {
+        actors.erase(std::remove_if(actors.begin(), actors.end(),
+                                    [](const ActorVM& a) { return a.released; }),
+                     actors.end());
+        closing.clear();
+    }
+}
+
+// ======= Actors =======
 
-    int resumes = 0;
-    double t = now;
+LuaScheduler& LuaScheduler::ActorScheduler(const Instance* actor) {
+    for (auto& a : actors) {
+        if (a.actor == actor && !a.released) return *a.sched;
+    }
+    ActorVM vm;
+    vm.actor = actor;
+    vm.sched = std::make_unique<LuaScheduler>();
+    vm.sched->isActor = true;
+    vm.sched->owner   = this;
+    vm.sched->gcPacing = gcPacing;
+    if (vm.sched->L_main) lua_gc(vm.sched->L_main, LUA_GCSETGOAL, gcPacing.goal);
+    if (stateSetup && vm.sched->L_main) stateSetup(vm.sched->L_main);
+    actors.push_back(std::move(vm));
+    LOGI("LuaScheduler: actor VM created (%zu actors)", actors.size());
+    return *actors.back().sched;
+}
+
+void LuaScheduler::ReleaseActor(const Instance* actor) {
+    for (auto& a : actors) {
+        if (a.actor == actor) a.released = true;
+    }
+}
 
-    // Resume script coroutines
-    while (!ready.empty()) {
-        if (resumes >= maxResumesPerFrame) break;
-        if (t >= deadline) break;
+void LuaScheduler::RunActorsParallel(double now) {
+    parallelJobs.clear();
+    for (auto& a : actors) {
+        LuaScheduler& s = *a.sched;
+        if (a.released) continue;
+        if (!s.parallelReady.Empty() || !s.parallelTasks.Empty() || !s.dispatchQueue[1].empty()) parallelJobs.push_back(&s);
+    }
+    if (parallelJobs.empty()) return;
+
+    // One job per actor: a VM is only ever entered by one thread at a time
+    const auto t0 = std::chrono::steady_clock::now();
+    std::atomic<int> resumed{0};
+    JobSystem::Get().ParallelFor(parallelJobs.size(), 1, [&](size_t begin, size_t end, int) {
+        tlParallelPhase = true;
+        for (size_t i = begin; i < end; ++i) resumed += parallelJobs[i]->RunParallelPhase(now);
+        tlParallelPhase = false;
+    });
+    frameStats.parallelResumes = resumed.load();
+    frameStats.parallelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
 
-        std::shared_ptr<BaseScript> s = ready.front();
-        ready.pop_front();
+int LuaScheduler::RunParallelPhase(double now) {
+    // No collection while the phase runs: finalizing Instance userdata drops
+    // engine references, and that must stay on the main thread
+    lua_gc(L_main, LUA_GCSTOP, 0);
 
-        auto it = state.find(s.get());
-        if (it == state.end()) continue;
-        auto& st = it->second;
+    // Only what was queued on entry; anything requeued waits for the next frame
+    int resumed = DrainDispatch(1, now);
+    for (size_t n = parallelReady.Size(); n > 0 && !parallelReady.Empty(); --n) {
+        if (ResumeScript(parallelReady.PopFront(scripts), now)) resumed++;
+    }
+    for (size_t n = parallelTasks.Size(); n > 0 && !parallelTasks.Empty(); --n) {
+        if (ResumeTask(parallelTasks.PopFront(tasks), now)) resumed++;
+    }
 
-        if (st.status != Status::Running) {
-            nextFrameQ.push_back(s);
-            continue;
+    lua_gc(L_main, LUA_GCRESTART, 0);
+    return resumed;
+}
+
+// ======= Resume =======
+
+bool LuaScheduler::ResumeScript(uint32_t slot, double now) {
+    const Handle h  = scripts.HandleAt(slot);
+    ScriptState* st = &scripts.At(slot);
+
+    if (st->status != Status::Running) {
+        nextFrameQ.PushBack(scripts, slot);
+        return false;
+    }
+
+    int nargs = 0;
+    if (st->hasPending) {
+        nargs = st->pendingArgc;
+        st->pendingArgc = 0;
+        st->hasPending  = false;
+        st->passDelta   = false;
+    } else if (st->passDelta && !st->firstResume) {
+        lua_pushnumber(st->co, st->resumeDelta);
+        nargs = 1;
+        st->passDelta = false;
+    }
+
+    lua_State* co = st->co;
+    const int r = lua_resume(co, nullptr, nargs);
+    if (r != LUA_OK && r != LUA_YIELD) {
+        LOGE("Luau Runtime Error: %s", lua_tostring(co, -1));
+        lua_pop(co, 1);
+    }
+
+    // the script may have stopped itself (script:Destroy()) while running
+    st = scripts.Get(h);
+    if (!st) return true;
+    st->firstResume = false;
+    st->lastResumeTime = now;
+
+    if (r == LUA_OK) {
+        st->status = Status::Done;
+    } else if (r == LUA_YIELD) {
+        if (st->status == Status::Waiting) {
+            if (st->nextFrame) nextFrameQ.PushBack(scripts, slot);
+            else if (!std::isinf(st->wakeTime)) sleepingByTime.Schedule(st, st->wakeTime); // only timed waits
+            // else parked on event: do not enqueue
+        } else {
+            Requeue(*st);
         }
+    } else {
+        st->status = Status::Error;
+    }
+    return true;
+}
+
+bool LuaScheduler::ResumeTask(uint32_t slot, double now) {
+    const Handle h = tasks.HandleAt(slot);
+    TaskState*  st = &tasks.At(slot);
 
-        int nargs = 0;
-        if (st.hasPending) {
-            nargs = st.pendingArgc;
-            st.pendingArgc = 0;
-            st.hasPending  = false;
-            st.passDelta   = false;
-        } else if (st.passDelta && !st.firstResume) {
-            lua_pushnumber(st.co, st.resumeDelta);
-            nargs = 1;
-            st.passDelta = false;
+    if (st->status != Status::Running) {
+        nextFrameTasks.PushBack(tasks, slot);
+        return false;
+    }
+
+    int nargs = 0;
+    if (st->hasPending) {
+        nargs = st->pendingArgc;
+        st->pendingArgc = 0;
+        st->hasPending  = false;
+        st->passDelta   = false;
+    } else if (st->firstResume) {
+        nargs = st->pendingArgc;
+        st->pendingArgc = 0;
+    } else if (st->passDelta) {
+        lua_pushnumber(st->co, st->resumeDelta);
+        nargs = 1;
+        st->passDelta = false;
+    }
+
+    lua_State* co = st->co;
+    const int r = lua_resume(co, nullptr, nargs);
+    if (r != LUA_OK && r != LUA_YIELD) {
+        LOGE("Luau Runtime Error (task): %s", lua_tostring(co, -1));
+        lua_pop(co, 1);
+    }
+
+    st = tasks.Get(h);
+    if (!st) return true;
+    st->firstResume = false;
+    st->lastResumeTime = now;
+
+    if (r == LUA_OK) {
+        // A task that owns its thread (spawn, delay, listener) lets go of it
+        if (st->registryRef != LUA_NOREF) {
+            DropTaskThread(*st);
+        } else {
+            // Reusable per-listener coroutine: clear any values left on its stack.
+            lua_settop(co, 0);
         }
+        DestroyTask(*st);
+    } else if (r == LUA_YIELD) {
+        QueueAfterYield(*st);
+    } else {
+        if (st->registryRef != LUA_NOREF) DropTaskThread(*st);
+        DestroyTask(*st);
+    }
+    return true;
+}
 
-        resumes++;
-        const int r = lua_resume(st.co, nullptr, nargs);
-        st.firstResume = false;
-        st.lastResumeTime = now;
-
-        if (r == LUA_OK) {
-            st.status = Status::Done;
-        } else if (r == LUA_YIELD) {
-            if (st.status == Status::Waiting) {
-                if (st.nextFrame) nextFrameQ.push_back(s);
-                else if (!std::isinf(st.wakeTime)) sleepingByTime.push(s); // only timed waits
-                // else parked on event: do not enqueue
-            } else {
-                nextFrameQ.push_back(s);
-            }
+void LuaScheduler::QueueAfterYield(TaskState& st) {
+    if (st.status == Status::Waiting) {
+        if (st.nextFrame) nextFrameTasks.PushBack(tasks, st.slot);
+        else if (!std::isinf(st.wakeTime)) sleepingTasks.Schedule(&st, st.wakeTime); // only timed waits
+        // else parked on event: do not enqueue
+    } else {
+        Requeue(st);
+    }
+}
+
+// ======= Signal dispatch =======
+
+int LuaScheduler::StashArgs(lua_State* src, int firstArgIdx, int argc, bool parallel) {
+    const int phase = parallel ? 1 : 0;
+    const int base  = stashTop[phase] + 1;
+    if (argc <= 0 || !L_main) return base;
+
+    const bool sameVM = From(src) == this;
+    lua_checkstack(L_main, 2);
+    lua_getref(L_main, stashRef[phase]);
+    for (int i = 0; i < argc; ++i) {
+        if (sameVM) {
+            lua_pushvalue(src, firstArgIdx + i);
+            lua_xmove(src, L_main, 1);
         } else {
-            LOGE("Luau Runtime Error: %s", lua_tostring(st.co, -1));
-            lua_pop(st.co, 1);
-            st.status = Status::Error;
+            Lua_PushCopy(L_main, src, firstArgIdx + i);
         }
+        lua_rawseti(L_main, -2, base + i);
+    }
+    lua_pop(L_main, 1);
+    stashTop[phase] += argc;
+    return base;
+}
+
+void LuaScheduler::QueueDispatch(RTScriptSignal* sig, uint32_t listener, size_t id, int argBase, int argc, bool parallel) {
+    dispatchQueue[parallel ? 1 : 0].push_back(Dispatch{ sig, listener, id, argBase, argc });
+}
+
+void LuaScheduler::CancelDispatch(const RTScriptSignal* sig) {
+    // Mark rather than erase: this can run from a listener (an instance
+    // destroyed mid-drain closes its signals) while DrainDispatch is indexing
+    // the queue. The stashed args are dropped with the rest at the drain.
+    for (auto& q : dispatchQueue) {
+        for (Dispatch& d : q) if (d.sig == sig) d.sig = nullptr;
+    }
+}
+
+// ---------------- Thread pool ----------------
+
+lua_State* LuaScheduler::AcquireThread(int& ref) {
+    if (!threadPool.empty()) {
+        const PooledThread t = threadPool.back();
+        threadPool.pop_back();
+        ref = t.ref;
+        return t.co;
+    }
+    return NewThread(ref);
+}
 
-        if ((resumes & 7) == 0) t = GetTime();
+lua_State* LuaScheduler::NewThread(int& ref) {
+    lua_State* co = lua_newthread(L_main);
+    luaL_sandboxthread(co);
+    ref = lua_ref(L_main, -1);
+    lua_pop(L_main, 1);
+    threadsCreated++;
+    return co;
+}
+
+void LuaScheduler::ReleaseThread(lua_State* co, int ref) {
+    if (!co || ref == LUA_NOREF) return;
+    if (threadPool.size() >= kMaxPooledThreads) {
+        lua_unref(L_main, ref);
+        return;
     }
+    // drops stack slots, call frames and open upvalues; the sandboxed
+    // globals table stays, so the thread is ready for the next function
+    lua_resetthread(co);
+    threadPool.push_back(PooledThread{ co, ref });
+}
 
-    // Resume TASK coroutines
-    while (!readyTasks.empty()) {
-        if (resumes >= maxResumesPerFrame) break;
-        if (t >= deadline) break;
+// Pooled listener threads are reset and reused (also after an error); threads
+// script has a handle to (task.spawn/delay) were never pooled and are only unref'd
+void LuaScheduler::DropTaskThread(TaskState& st) {
+    if (st.pooledThread) ReleaseThread(st.co, st.registryRef);
+    else lua_unref(L_main, st.registryRef);
+    st.registryRef  = LUA_NOREF;
+    st.pooledThread = false;
+}
 
-        lua_State* co = readyTasks.front();
-        readyTasks.pop_front();
+LuaScheduler::PooledThread LuaScheduler::TakeThread() {
+    PooledThread t;
+    t.co = AcquireThread(t.ref);
+    return t;
+}
 
-        auto it = tasks.find(co);
-        if (it == tasks.end()) continue;
-        auto& st = it->second;
+void LuaScheduler::RunListener(const PooledThread& t, int argc, int phase, double now) {
+    const PooledThread outer = dispatching;   // nested fires resume their own listeners
+    dispatching = t;
+    const int r = lua_resume(t.co, nullptr, argc);
+    dispatching = outer;
+
+    if (r == LUA_OK) {
+        ReleaseThread(t.co, t.ref);
+    } else if (r == LUA_YIELD) {
+        // the listener lives on as a task; it may have been adopted already by a wait
+        TaskState* st = FindTask(t.co);
+        if (!st) {
+            st = &AcquireTask(t.co);
+            st->status      = Status::Running;
+            st->registryRef = t.ref;
+            st->pooledThread = true;
+            st->parallel    = (phase == 1);
+        }
+        st->firstResume    = false;
+        st->lastResumeTime = now;
+        QueueAfterYield(*st);
+    } else {
+        LOGE("Luau Runtime Error (signal): %s", lua_tostring(t.co, -1));
+        if (TaskState* st = FindTask(t.co)) DestroyTask(*st);
+        ReleaseThread(t.co, t.ref);
+    }
+}
 
-        if (st.status != Status::Running) {
-            nextFrameTasks.push_back(co);
+bool LuaScheduler::DispatchNow(RTScriptSignal* sig, uint32_t listener, size_t id, lua_State* src, int firstArgIdx, int argc) {
+    if (!L_main) return false;
+    const PooledThread t = TakeThread();
+    if (!lua_checkstack(t.co, 1 + argc) || !sig->PushCallback(t.co, listener, id)) {
+        threadPool.push_back(t);
+        return false;
+    }
+    const bool sameVM = From(src) == this;
+    for (int i = 0; i < argc; ++i) {
+        if (sameVM) {
+            lua_pushvalue(src, firstArgIdx + i);
+            lua_xmove(src, t.co, 1);
+        } else {
+            Lua_PushCopy(t.co, src, firstArgIdx + i);
+        }
+    }
+    RunListener(t, argc, 0, GetTime());
+    immediateDispatched++;
+    return true;
+}
+
+int LuaScheduler::DrainDispatch(int phase, double now) {
+    std::vector<Dispatch>& q = dispatchQueue[phase];
+    int resumed = 0;
+
+    // By index: a listener may fire more signals, which run in this pass too
+    for (size_t i = 0; i < q.size(); ++i) {
+        const Dispatch d = q[i];
+        if (!d.sig) continue;   // cancelled
+        const PooledThread t = TakeThread();
+
+        // callback (nothing if it was disconnected since the fire), then args
+        if (!lua_checkstack(t.co, 2 + d.argc) || !d.sig->PushCallback(t.co, d.listener, d.id)) {
+            threadPool.push_back(t);
             continue;
         }
+        if (d.argc > 0) {
+            lua_getref(t.co, stashRef[phase]);
+            const int stash = lua_gettop(t.co);
+            for (int a = 0; a < d.argc; ++a) lua_rawgeti(t.co, stash, d.argBase + a);
+            lua_remove(t.co, stash);
+        }
 
-        int nargs = 0;
-        if (st.hasPending) {
-            nargs = st.pendingArgc;
-            st.pendingArgc = 0;
-            st.hasPending  = false;
-            st.passDelta   = false;
-        } else if (st.firstResume) {
-            nargs = st.pendingArgc;
-            st.pendingArgc = 0;
-        } else if (st.passDelta) {
-            lua_pushnumber(st.co, st.resumeDelta);
-            nargs = 1;
-            st.passDelta = false;
+        RunListener(t, d.argc, phase, now);
+        resumed++;
+    }
+    q.clear();
+
+    // Drop the stashed args so they do not keep objects alive
+    if (stashTop[phase] > 0) {
+        lua_getref(L_main, stashRef[phase]);
+        for (int k = 1; k <= stashTop[phase]; ++k) {
+            lua_pushnil(L_main);
+            lua_rawseti(L_main, -2, k);
         }
+        lua_pop(L_main, 1);
+        stashTop[phase] = 0;
+    }
+    return resumed;
+}
 
-        resumes++;
-        const int r = lua_resume(st.co, nullptr, nargs);
-        st.firstResume = false;
-        st.lastResumeTime = now;
+// ---------------- GC pacing ----------------
 
-        if (r == LUA_OK) {
-            // If this task carried a registry ref it is ephemeral and must be unref'd.
-            if (st.registryRef != LUA_NOREF) {
-                lua_unref(L_main, st.registryRef);
-                st.registryRef = LUA_NOREF;
-            } else {
-                // Reusable per-listener coroutine: clear any values left on its stack.
-                lua_settop(st.co, 0);
-            }
-            tasks.erase(it);
-        } else if (r == LUA_YIELD) {
-            if (st.status == Status::Waiting) {
-                if (st.nextFrame) nextFrameTasks.push_back(co);
-                else if (!std::isinf(st.wakeTime)) sleepingTasks.push(co); // only timed waits
-                // else parked on event: do not enqueue
-            } else {
-                nextFrameTasks.push_back(co);
-            }
+void LuaScheduler::SetGcGoal(int goal) {
+    gcPacing.automatic = false;
+    gcPacing.goal      = goal;
+    if (L_main) lua_gc(L_main, LUA_GCSETGOAL, goal);
+    for (auto& a : actors) a.sched->SetGcGoal(goal);
+}
+
+void LuaScheduler::StepGC(double budgetSeconds) {
+    if (!L_main) return;
+    const auto t0 = std::chrono::steady_clock::now();
+    auto elapsed = [&t0] {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    const double slice = std::clamp(budgetSeconds, gcPacing.minStepSeconds, gcPacing.maxStepSeconds);
+    const size_t heapKB = (size_t)lua_gc(L_main, LUA_GCCOUNT, 0);
+
+    // a heap below the last live size means allocation finished a cycle on its own
+    if (!gcCycle.active && (gcCycle.liveKB == 0 || heapKB < gcCycle.liveKB)) gcCycle.liveKB = heapKB;
+
+    // Pull the next cycle into idle time once the heap is halfway to its goal;
+    // the collector's own trigger sits closer to the goal
+    const size_t startKB = gcCycle.liveKB + gcCycle.liveKB * (size_t)std::max(gcPacing.goal - 100, 0) / 200;
+    if (gcCycle.active || heapKB >= startKB) {
+        gcCycle.active = true;
+        gcCycle.frames++;
+        bool finished = false;
+        do {
+            finished = lua_gc(L_main, LUA_GCSTEP, 0) == 1;
+        } while (!finished && elapsed() < slice);
+
+        if (finished) {
+            gcCycle.liveKB = (size_t)lua_gc(L_main, LUA_GCCOUNT, 0);
+            if (gcPacing.automatic) RetuneGcGoal();
+            gcCycle = GcCycle{ gcCycle.liveKB };
         } else {
-            LOGE("Luau Runtime Error (task): %s", lua_tostring(st.co, -1));
-            lua_pop(st.co, 1);
-            if (st.registryRef != LUA_NOREF) {
-                lua_unref(L_main, st.registryRef);
-                st.registryRef = LUA_NOREF;
-            }
-            tasks.erase(it);
+            gcCycle.behindFrames++;
         }
+    }
+
+    frameStats.gcSeconds = elapsed();
+    frameStats.heapKB    = (size_t)lua_gc(L_main, LUA_GCCOUNT, 0);
+    frameStats.gcGoal    = gcPacing.goal;
+
+    for (auto& a : actors) {
+        if (!a.released) a.sched->StepGC(budgetSeconds - elapsed());
+    }
+}
 
-        if ((resumes & 7) == 0) t = GetTime();
+void LuaScheduler::RetuneGcGoal() {
+    int goal = gcPacing.goal;
+    if (gcCycle.behindFrames * 2 > gcCycle.frames) goal += 25;          // collect less often
+    else if (gcCycle.behindFrames == 0 && gcCycle.frames <= 2) goal -= 10; // idle time to spare: smaller heap
+    goal = std::clamp(goal, gcPacing.minGoal, gcPacing.maxGoal);
+    if (goal != gcPacing.goal) {
+        gcPacing.goal = goal;
+        lua_gc(L_main, LUA_GCSETGOAL, goal);
     }
 }
@@ -2,10 +2,9 @@
 #pragma once
 
 #include <cstdint>
-#include <deque>
 #include <functional>
+#include <map>
 #include <memory>
-#include <queue>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -15,65 +14,188 @@
 #include "lualib.h"
 #include "luacode.h"
 
+#include "bootstrap/BytecodeCache.h"
+#include "bootstrap/Slab.h"
+#include "bootstrap/TimerHeap.h"
+
 struct BaseScript;  // opaque to the scheduler
+struct RTScriptSignal;
+struct Instance;    // Actor keys, never dereferenced
 
 class LuaScheduler {
 public:
     using GlobalBinder = std::function<void(lua_State* co, BaseScript* self)>;
+    // Registers the engine API and globals on a freshly created VM
+    using StateSetup   = std::function<void(lua_State* L)>;
 
     enum class Status { New, Running, Waiting, Done, Error };
 
+    // Generation-checked reference to a script or task record; goes stale
+    // once the script is stopped or the task finishes
+    using Handle = SlabHandle;
+
     LuaScheduler();
     ~LuaScheduler();
 
     lua_State* GetMainState() const { return L_main; }
 
+    // Scheduler that owns the VM of 'L' (any thread of it)
+    static LuaScheduler* From(lua_State* L);
+
+    // Native code generation (builds with LB_CODEGEN). Off: only scripts that
+    // start with --!native are compiled to machine code. On (--native): all are.
+    static void SetNativeCodegen(bool all);
+    // Directory for the on-disk bytecode cache (--bytecode-cache); empty keeps it in memory
+    static void SetBytecodeCacheDir(const std::string& dir);
+
     void AddScript(const std::shared_ptr<BaseScript>& script,
                    const std::string&                 name,
                    const std::string&                 source,
                    const GlobalBinder&                binder);
 
+    // Also finds scripts running in actor VMs
     void StopScript(BaseScript* s);
     void StopScript(const std::shared_ptr<BaseScript>& s) { StopScript(s.get()); }
 
     void Step(double now, double dt = 0.0);
 
-    // Script waits
-    void SetWaitAbs(BaseScript* s, double wakeTimeAbs);
-    void SetWaitNextFrame(BaseScript* s);
-    void SetWaitEvent(BaseScript* s);
+    // Script waits; SetWaitEvent parks the script until it is woken through the handle
+    void   SetWaitAbs(BaseScript* s, double wakeTimeAbs);
+    void   SetWaitNextFrame(BaseScript* s);
+    Handle SetWaitEvent(BaseScript* s);
 
     // Task API (thread-based, not tied to BaseScript)
-    void ScheduleTaskNextFrame(lua_State* co, int registryRef, int initialArgc);
-    void ScheduleTaskAt(lua_State* co, int registryRef, double wakeTimeAbs, int initialArgc);
-    void SetTaskWaitAbs(lua_State* co, double wakeTimeAbs);
-    void SetTaskWaitNextFrame(lua_State* co);
-    void SetTaskWaitEvent(lua_State* co);
-    void WakeTaskNextFrame(lua_State* co, int argc);
+    void   ScheduleTaskNextFrame(lua_State* co, int registryRef, int initialArgc);
+    void   ScheduleTaskAt(lua_State* co, int registryRef, double wakeTimeAbs, int initialArgc);
+    void   SetTaskWaitAbs(lua_State* co, double wakeTimeAbs);
+    void   SetTaskWaitNextFrame(lua_State* co);
+    Handle SetTaskWaitEvent(lua_State* co);
+
+    // Resume a parked script/task with 'argc' args already pushed on its thread
+    void ResumeScriptNextFrame(Handle h, int argc);
+    void WakeTaskNextFrame(Handle h, int argc);
+
+    // Thread behind a handle; nullptr once the handle is stale (RTScriptSignal waiters)
+    lua_State* GetScriptThread(Handle h);
+    lua_State* GetTaskThread(Handle h);
+
+    // ---- Actors ----
+    // Every Actor gets its own VM (created through the StateSetup) and
+    // scheduler, stepped serially from this one's Step(). After the serial
+    // phase, threads that called task.desynchronize() run in a parallel phase:
+    // one job per actor on the JobSystem, with the Instance tree read-only.
+    void SetStateSetup(StateSetup fn) { stateSetup = std::move(fn); }
+    LuaScheduler& ActorScheduler(const Instance* actor);
+    // The actor's VM is closed at the end of the current Step(). Called from
+    // Actor::Destroy and ~Actor, so a new Actor at a reused address never
+    // finds the old VM.
+    void ReleaseActor(const Instance* actor);
+    bool IsActor() const { return isActor; }
+
+    // Moves a running script (self) or task thread (co) between the serial
+    // and parallel phases; it takes effect when the thread yields. False if
+    // the thread is not scheduled here.
+    bool SetThreadParallel(BaseScript* self, lua_State* co, bool parallel);
 
-    // resume script with 'argc' args already pushed on target coroutine
-    void ResumeScriptNextFrame(BaseScript* s, int argc);
+    // True on a thread that is running an actor's parallel phase
+    static bool InParallelPhase();
 
-    // For RTScriptSignal::Wait() on scripts
-    lua_State* GetScriptThread(BaseScript* s);
+    // ---- Signal dispatch ----
+    // Fired listeners wait in a flat queue per phase and are resumed directly
+    // on pooled threads at the start of the next Step() (parallel ones in the
+    // actor's parallel phase). A listener only becomes a task record if it
+    // yields. Arguments are stashed once per fire and shared by its listeners.
+    int  StashArgs(lua_State* src, int firstArgIdx, int argc, bool parallel);   // returns the base
+    void QueueDispatch(RTScriptSignal* sig, uint32_t listener, size_t id, int argBase, int argc, bool parallel);
+    // Drop queued calls into a signal that is going away (safe mid-drain)
+    void CancelDispatch(const RTScriptSignal* sig);
+    // Immediate signal behavior: run a serial listener right now on a pooled
+    // thread, args taken from 'src'. False if it was disconnected meanwhile.
+    bool DispatchNow(RTScriptSignal* sig, uint32_t listener, size_t id, lua_State* src, int firstArgIdx, int argc);
+
+    // ---- Thread pool ----
+    // Sandboxed threads on this VM for signal listeners. A listener thread
+    // that finishes or errors is reset (lua_resetthread) and reused, so
+    // dispatch costs a stack reset rather than a GC allocation plus sandbox
+    // setup. Threads returned to script (task.spawn, task.delay) come from
+    // NewThread and are never pooled: a script holding the handle must not
+    // see it run someone else's code. 'ref' keeps the thread alive.
+    lua_State* NewThread(int& ref);
+    lua_State* AcquireThread(int& ref);
+    void       ReleaseThread(lua_State* co, int ref);
+    static constexpr size_t kMaxPooledThreads = 4096;   // idle threads kept (about 1 KB each)
+
+    // ---- GC pacing ----
+    // Step() does no collection of its own. The host calls StepGC() once a
+    // frame with the time left after scripts and rendering, and the pacer does
+    // incremental GC work in that window. It gets at least minStepSeconds, so
+    // it keeps up on busy frames, and idles while the heap is still well short
+    // of the next cycle's goal. Actor VMs are paced from what is left.
+    struct GcPacing {
+        bool   automatic      = true;    // retune 'goal' after every cycle the pacer finishes
+        int    goal           = 200;     // LUA_GCSETGOAL: heap growth allowed over live data, percent
+        int    minGoal        = 150;
+        int    maxGoal        = 400;
+        double minStepSeconds = 0.0002;
+        double maxStepSeconds = 0.004;
+    };
+    GcPacing gcPacing;
+    void StepGC(double budgetSeconds);
+    // Manual tuning (--gc-goal): fixes the goal and turns automatic tuning off
+    void SetGcGoal(int goal);
+
+    // Liveness token for holders of raw scheduler pointers (signal listeners
+    // in actor VMs); expires when the scheduler is destroyed
+    std::weak_ptr<void> Lifetime() const { return lifetime; }
 
     int    maxResumesPerFrame   = 4096;
     double maxTimeBudgetSeconds = 0.010;
 
+    // Ready work is split into lanes: scripts by RunContext, plus tasks.
+    enum Lane : uint8_t { Lane_Server, Lane_Client, Lane_Plugin, Lane_Tasks, Lane_Count };
+
+    // Fair: lanes take turns, each resuming up to its weight per turn, until the
+    // frame budget runs out. ScriptsFirst: drain lanes in order (tasks last).
+    enum class ResumePolicy { Fair, ScriptsFirst };
+    ResumePolicy resumePolicy = ResumePolicy::Fair;
+    int laneWeights[Lane_Count] = { 2, 2, 1, 2 };
+
+    // Counters for the last Step(), for tuning the budgets above
+    struct FrameStats {
+        int    resumes = 0;
+        int    laneResumes[Lane_Count]{};
+        size_t readyDepth[Lane_Count]{};      // ready at the start of the frame
+        size_t deferred[Lane_Count]{};        // still ready when the budget ran out
+        size_t sleeping = 0;                  // timed sleepers, scripts and tasks
+        double resumeSeconds = 0.0;           // total time inside lua_resume
+        double worstResumeSeconds = 0.0;
+        bool   budgetExhausted = false;
+        size_t heapKB = 0;                    // VM heap after StepGC()
+        double gcSeconds = 0.0;               // paced GC work, this VM only
+        int    gcGoal = 0;
+        int    dispatched = 0;                // signal listeners run, queued or immediate
+        int    parallelResumes = 0;           // actor threads resumed in the parallel phase
+        double parallelSeconds = 0.0;         // wall time of the parallel phase
+    };
+    const FrameStats& GetFrameStats() const { return frameStats; }
+
     uint64_t frameIndex = 0;
 
     LuaScheduler(const LuaScheduler&)            = delete;
     LuaScheduler& operator=(const LuaScheduler&) = delete;
 
-    // Query whether a task coroutine is currently in the scheduler's active/tasks map.
-    bool IsTaskActive(lua_State* co) const { return tasks.find(co) != tasks.end(); }
+    // Query whether a task coroutine is currently scheduled, waiting or running.
+    bool IsTaskActive(lua_State* co) const { return taskByThread.find(co) != taskByThread.end(); }
 
 private:
     struct ScriptState {
         Status     status    = Status::New;
+        BaseScript* script   = nullptr;
         lua_State* co        = nullptr;
         double     wakeTime  = 0.0;
+        int32_t    heapIndex = -1;        // position in sleepingByTime
         bool       nextFrame = false;
+        bool       parallel  = false;     // desynchronized: resumes in the parallel phase
         // timing and resume
         double     lastResumeTime = 0.0;
         bool       passDelta      = false;
@@ -82,14 +204,21 @@ private:
         // pending arguments
         bool       hasPending     = false;
         int        pendingArgc    = 0;
+        // scheduler links
+        uint32_t   slot           = 0;    // own index in 'scripts'
+        uint8_t    lane           = Lane_Server;
+        SlabLink   link;                  // ready[lane] / parallelReady / nextFrameQ
     };
 
     struct TaskState {
         Status     status      = Status::Running;
         lua_State* co          = nullptr;
         int        registryRef = LUA_NOREF; // keeps thread alive (ephemeral tasks)
+        bool       pooledThread = false;     // listener thread never handed to script; back to the pool when done
         double     wakeTime    = 0.0;
+        int32_t    heapIndex   = -1;        // position in sleepingTasks
         bool       nextFrame   = false;
+        bool       parallel    = false;
         // timing and resume
         double     lastResumeTime = 0.0;
         bool       passDelta      = false;
@@ -98,51 +227,121 @@ private:
         // pending arguments
         bool       hasPending     = false;
         int        pendingArgc    = 0;
+        // scheduler links
+        uint32_t   slot           = 0;    // own index in 'tasks'
+        SlabLink   link;                  // readyTasks / parallelTasks / nextFrameTasks
     };
 
     lua_State* L_main = nullptr;
+    bool       codegen = false;   // Luau.CodeGen initialized on L_main
+
+    // Push a fresh closure of the script's main function on 'co'
+    bool LoadChunk(lua_State* co, const std::string& name, const std::string& source);
+
+    BytecodeCache bytecodeCache;
+    // Loaded main functions on L_main (registry refs) by bytecode key and chunk
+    // name; scripts with the same source and name clone one shared proto.
+    std::map<std::pair<BytecodeCache::Key, std::string>, int> protoRefs;
+
+    // Scheduler records live in slabs and move between intrusive lists, so
+    // per-frame scheduling neither allocates nor touches refcounts. A record is
+    // on at most one of its kind's lists; timed sleepers sit in the heaps.
 
     // BaseScript coroutines
-    std::unordered_map<BaseScript*, ScriptState> state;
-    std::deque<std::shared_ptr<BaseScript>> ready;
-    std::deque<std::shared_ptr<BaseScript>> nextFrameQ;
-
-    struct TimeCmp {
-        const std::unordered_map<BaseScript*, ScriptState>* st = nullptr;
-        bool operator()(const std::shared_ptr<BaseScript>& a,
-                        const std::shared_ptr<BaseScript>& b) const {
-            const auto ia = st->find(a.get());
-            const auto ib = st->find(b.get());
-            const double ta = (ia == st->end()) ? 0.0 : ia->second.wakeTime;
-            const double tb = (ib == st->end()) ? 0.0 : ib->second.wakeTime;
-            return ta > tb; // min-heap
-        }
+    Slab<ScriptState> scripts;
+    std::unordered_map<BaseScript*, Handle> scriptByOwner;
+    SlabList<ScriptState> ready[Lane_Tasks];   // one per script lane
+    SlabList<ScriptState> parallelReady;
+    SlabList<ScriptState> nextFrameQ;
+    TimerHeap<ScriptState> sleepingByTime;
+
+    // Task coroutines (plain Luau threads)
+    Slab<TaskState> tasks;
+    std::unordered_map<lua_State*, Handle> taskByThread;
+    SlabList<TaskState> readyTasks;
+    SlabList<TaskState> parallelTasks;
+    SlabList<TaskState> nextFrameTasks;
+    TimerHeap<TaskState> sleepingTasks;
+
+    ScriptState* FindScript(BaseScript* s);
+    TaskState*   FindTask(lua_State* co);
+    TaskState&   AcquireTask(lua_State* co);   // existing record (unlinked) or a new one
+    void UnlinkScript(ScriptState& st);   // off every list and the heap
+    void UnlinkTask(TaskState& st);
+    void DestroyTask(TaskState& st);      // unref, unlink and free the record
+    // Queue a runnable record for the phase it belongs to
+    void MakeReady(ScriptState& st);
+    void MakeReady(TaskState& st);
+    // A thread that yielded without waiting: the other phase's list if it
+    // switched phase, otherwise next frame
+    void Requeue(ScriptState& st);
+    void Requeue(TaskState& st);
+    // Park or queue a task that just yielded, by what it is waiting for
+    void QueueAfterYield(TaskState& st);
+
+    // Resume one ready record; returns false if it was not runnable yet
+    bool ResumeScript(uint32_t slot, double now);
+    bool ResumeTask(uint32_t slot, double now);
+
+    FrameStats frameStats;
+    int        starvedFrames[Lane_Count]{};   // consecutive frames with deferred work
+
+    // Signal dispatch, indexed by phase (0 serial, 1 parallel)
+    struct Dispatch {
+        RTScriptSignal* sig;
+        uint32_t        listener;
+        size_t          id;
+        int             argBase;
+        int             argc;
+    };
+    struct PooledThread {
+        lua_State* co  = nullptr;
+        int        ref = LUA_NOREF;
     };
+    std::vector<Dispatch>     dispatchQueue[2];
+    int                       stashRef[2] = { LUA_NOREF, LUA_NOREF };   // tables of fired args
+    int                       stashTop[2] = { 0, 0 };
+    std::vector<PooledThread> threadPool;    // idle reset threads (AcquireThread)
+    size_t                    threadsCreated = 0;
+    PooledThread              dispatching;   // listener thread being resumed right now
+    int                       immediateDispatched = 0;   // DispatchNow calls since the last Step
 
-    std::priority_queue<
-        std::shared_ptr<BaseScript>,
-        std::vector<std::shared_ptr<BaseScript>>,
-        TimeCmp
-    > sleepingByTime;
+    // Run every queued listener of a phase; returns how many were resumed
+    int          DrainDispatch(int phase, double now);
+    PooledThread TakeThread();
+    void         DropTaskThread(TaskState& st);
+    // Resume a listener whose callback and args are on t.co; a thread that
+    // returns goes back to the pool, one that yields becomes a task
+    void         RunListener(const PooledThread& t, int argc, int phase, double now);
+    // Task record for the running listener thread, created when it first waits
+    TaskState*   FindOrAdoptTask(lua_State* co);
 
-    // Task coroutines (plain Luau threads)
-    std::unordered_map<lua_State*, TaskState> tasks;
-    std::deque<lua_State*> readyTasks;
-    std::deque<lua_State*> nextFrameTasks;
-
-    struct TaskTimeCmp {
-        const std::unordered_map<lua_State*, TaskState>* st = nullptr;
-        bool operator()(lua_State* a, lua_State* b) const {
-            auto ia = st->find(a), ib = st->find(b);
-            const double ta = (ia == st->end()) ? 0.0 : ia->second.wakeTime;
-            const double tb = (ib == st->end()) ? 0.0 : ib->second.wakeTime;
-            return ta > tb; // min-heap
-        }
+    // Actor VMs (only on the game's scheduler)
+    struct ActorVM {
+        const Instance*               actor = nullptr;
+        std::unique_ptr<LuaScheduler> sched;
+        bool                          released = false;
+    };
+    std::vector<ActorVM>       actors;
+    std::vector<LuaScheduler*> parallelJobs;   // actors with parallel work this frame
+    StateSetup                 stateSetup;
+    bool                       isActor  = false;
+    LuaScheduler*              owner    = nullptr;   // game scheduler of an actor; shares its bytecode cache
+    std::shared_ptr<int>       lifetime = std::make_shared<int>(0);
+
+    // Pacer progress through the current GC cycle
+    struct GcCycle {
+        size_t liveKB       = 0;       // heap when the last cycle finished
+        bool   active       = false;   // the pacer has stepped into a cycle
+        int    frames       = 0;       // frames it has stepped so far
+        int    behindFrames = 0;       // of those, frames that used the whole slice
     };
+    GcCycle gcCycle;
+    // Automatic tuning, at the end of a cycle: raise the goal when the pacer
+    // fell behind on most frames, lower it when the cycle was cheap
+    void RetuneGcGoal();
 
-    std::priority_queue<
-        lua_State*,
-        std::vector<lua_State*>,
-        TaskTimeCmp
-    > sleepingTasks;
+    // Resume this actor's desynchronized threads; runs on a job worker
+    int  RunParallelPhase(double now);
+    void RunActorsParallel(double now);
 };
@@ -0,0 +1,174 @@
+// ================== bootstrap/Reflection.h ==================
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "lua.h"
+#include "lualib.h"
+
+#include "bootstrap/LuaAtoms.h"
+#include "core/datatypes/CFrame.h"
+#include "core/datatypes/Color3.h"
+#include "core/datatypes/Vector3Game.h"
+
+struct Instance;
+
+// Property reflection. A class lists each property once, with its name atom,
+// accessors and flags, in a table built at compile time:
+//
+//     static constexpr PropertyInfo kProps[] = {
+//         Property<&Lighting::ClockTime>(Atom_ClockTime),                 // field
+//         Property<&BasePart::GetSize, &BasePart::SetSize>(Atom_Size),     // accessors
+//     };
+//     static constexpr PropertyTable kTable(kProps);
+//
+// and returns it from Instance::Properties(). Atoms are dense (Luau interns
+// them per string), so the table indexes its entries by atom: __index and
+// __newindex find a property with one array load. Clone() copies through the
+// same entries, and a place writer would enumerate the Prop_Serialize ones.
+
+enum PropertyFlags : uint8_t {
+    Prop_ReadOnly  = 1u << 0,   // no setter; set automatically for getter-only properties
+    Prop_Serialize = 1u << 1,   // part of the saved state; Clone() copies it
+    Prop_Replicate = 1u << 2,   // sent to clients once there are any
+    Prop_Hidden    = 1u << 3,   // not visible to scripts
+    Prop_Default   = Prop_Serialize | Prop_Replicate,
+};
+
+struct PropertyInfo {
+    int16_t atom  = Atom_None;
+    uint8_t flags = 0;
+    void (*get)(lua_State* L, const Instance* self) = nullptr;
+    void (*set)(lua_State* L, Instance* self, int valueIndex) = nullptr;   // nullptr when read-only
+    void (*copy)(const Instance* src, Instance* dst) = nullptr;            // nullptr when read-only
+
+    const char* Name() const { return LuaAtomName(atom); }
+};
+
+namespace reflect {
+
+// Lua conversion per property type; engine datatypes go through lb::push/check
+template <class T> struct LuaValue {
+    static void Push(lua_State* L, const T& v) { lb::push(L, v); }
+    static T    Check(lua_State* L, int idx) { return *lb::check<T>(L, idx); }
+};
+template <> struct LuaValue<bool> {
+    static void Push(lua_State* L, bool v) { lua_pushboolean(L, v); }
+    static bool Check(lua_State* L, int idx) { luaL_checktype(L, idx, LUA_TBOOLEAN); return lua_toboolean(L, idx) != 0; }
+};
+template <> struct LuaValue<double> {
+    static void   Push(lua_State* L, double v) { lua_pushnumber(L, v); }
+    static double Check(lua_State* L, int idx) { return luaL_checknumber(L, idx); }
+};
+template <> struct LuaValue<float> {
+    static void  Push(lua_State* L, float v) { lua_pushnumber(L, v); }
+    static float Check(lua_State* L, int idx) { return (float)luaL_checknumber(L, idx); }
+};
+template <> struct LuaValue<std::string> {
+    static void Push(lua_State* L, const std::string& v) { lua_pushlstring(L, v.data(), v.size()); }
+    static std::string Check(lua_State* L, int idx) { size_t n = 0; const char* s = luaL_checklstring(L, idx, &n); return std::string(s, n); }
+};
+template <> struct LuaValue<::Vector3> {   // raylib vectors appear as Vector3 to scripts
+    static void      Push(lua_State* L, const ::Vector3& v) { lb::push(L, Vector3Game::fromRay(v)); }
+    static ::Vector3 Check(lua_State* L, int idx) { return lb::check<Vector3Game>(L, idx)->toRay(); }
+};
+
+// Field: T C::*
+template <auto M> struct FieldAccess;
+template <class C, class T, T C::*M> struct FieldAccess<M> {
+    using Class = C;
+    using Value = T;
+    static Value Get(const C& c) { return c.*M; }
+    static void  Set(C& c, const Value& v) { c.*M = v; }
+    static constexpr bool kWritable = true;
+};
+
+// Getter R (C::*)() const, optional setter void (C::*)(A)
+template <auto G, auto S> struct MethodAccess;
+template <class C, class R, R (C::*G)() const, class A, void (C::*S)(A)> struct MethodAccess<G, S> {
+    using Class = C;
+    using Value = std::decay_t<R>;
+    static Value Get(const C& c) { return (c.*G)(); }
+    static void  Set(C& c, const Value& v) { (c.*S)(v); }
+    static constexpr bool kWritable = true;
+};
+template <class C, class R, R (C::*G)() const> struct MethodAccess<G, nullptr> {
+    using Class = C;
+    using Value = std::decay_t<R>;
+    static Value Get(const C& c) { return (c.*G)(); }
+    static void  Set(C&, const Value&) {}
+    static constexpr bool kWritable = false;
+};
+
+template <auto G, auto S>
+using Access = std::conditional_t<std::is_member_object_pointer_v<decltype(G)>, FieldAccess<G>, MethodAccess<G, S>>;
+
+} // namespace reflect
+
+// One property: a field (Property<&C::field>) or accessors (Property<&C::Get, &C::Set>;
+// leave out the setter for a read-only one)
+template <auto G, auto S = nullptr>
+constexpr PropertyInfo Property(LuaAtom atom, uint8_t flags = Prop_Default) {
+    using A = reflect::Access<G, S>;
+    using C = typename A::Class;
+    using V = typename A::Value;
+
+    PropertyInfo p;
+    p.atom  = atom;
+    p.flags = A::kWritable ? flags : uint8_t(flags | Prop_ReadOnly);
+    p.get   = [](lua_State* L, const Instance* self) {
+        reflect::LuaValue<V>::Push(L, A::Get(*static_cast<const C*>(self)));
+    };
+    if constexpr (A::kWritable) {
+        p.set = [](lua_State* L, Instance* self, int valueIndex) {
+            A::Set(*static_cast<C*>(self), reflect::LuaValue<V>::Check(L, valueIndex));
+        };
+        p.copy = [](const Instance* src, Instance* dst) {
+            A::Set(*static_cast<C*>(dst), A::Get(*static_cast<const C*>(src)));
+        };
+    }
+    return p;
+}
+
+// A class's properties, indexed by atom. 'base' is the parent class's table;
+// lookups fall back to it, so derived classes list only what they add.
+class PropertyTable {
+public:
+    template <size_t N>
+    constexpr explicit PropertyTable(const PropertyInfo (&props)[N], const PropertyTable* base = nullptr)
+        : props(props), count(N), base(base) {
+        static_assert(N < 255, "slot is a uint8_t");
+        for (size_t i = 0; i < N; ++i) slot[(size_t)props[i].atom] = uint8_t(i + 1);
+    }
+
+    const PropertyInfo* Find(int atom) const {
+        if (atom < 0 || atom >= Atom_Count) return nullptr;
+        for (const PropertyTable* t = this; t; t = t->base) {
+            if (const uint8_t s = t->slot[(size_t)atom]) return &t->props[s - 1];
+        }
+        return nullptr;
+    }
+
+    // Every property, base classes first
+    template <class F>
+    void ForEach(F&& f) const {
+        if (base) base->ForEach(f);
+        for (size_t i = 0; i < count; ++i) f(props[i]);
+    }
+
+    // Clone(): every Prop_Serialize property of 'src' onto 'dst' (same class)
+    void CopyValues(const Instance* src, Instance* dst) const {
+        ForEach([&](const PropertyInfo& p) {
+            if ((p.flags & Prop_Serialize) && p.copy) p.copy(src, dst);
+        });
+    }
+
+private:
+    const PropertyInfo*              props;
+    size_t                           count;
+    const PropertyTable*             base;
+    std::array<uint8_t, Atom_Count>  slot{};   // index + 1 into props; 0 = not declared here
+};
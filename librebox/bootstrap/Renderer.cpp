@@ -9,23 +9,34 @@
 #include <cfloat>
 #include <unordered_map>
 #include <cstdint>
+#include <cstring>
 #include "bootstrap/Game.h"
 #include "bootstrap/instances/InstanceTypes.h"
 #include "bootstrap/instances/BasePart.h"      // for CF
+#include "bootstrap/rendering/SpatialIndex.h"  // for culling
+#include "bootstrap/rendering/RenderScene.h"   // retained instance buffers
+#include "bootstrap/rendering/DepthSort.h"     // transparent ordering
+#include "bootstrap/JobSystem.h"               // parallel render list extraction
 #include "core/datatypes/CFrame.h"             // for CF
+#include "core/logging/Logging.h"
 
 extern std::shared_ptr<Game> g_game;
 
 // ---------------- Tunables ----------------
 static float kMaxDrawDistance = 10000.0f;
-static float kFovPaddingDeg   = 20.0f;
 
 // shadow parameter definitions
 static float kShadowMaxDistance = 200.0f;  // how far from the camera to cover with shadows
+static float kShadowCasterReach = 200.0f;  // light cam offset toward the sun; casters further out are clipped
 static int   kShadowRes         = 1536;    // per-cascade resolution
 static float kPCFStep           = 1.0f;    // pcf step in texels
 static bool  kCullBackFace      = true;
 static bool  kStabilizeShadow   = true;    // snap to texel grid to prevent swimming
+static bool  kCacheShadowMaps   = true;    // skip re-rendering cascades whose light cam and casters are unchanged
+static float kCascadeTransition = 0.15f;   // blend band as a fraction of each split distance
+static int   kDenseBatchRatio   = 4;       // draw a color batch's whole buffer once 1/N of it is visible
+static bool  kWeightedOIT       = false;   // weighted blended OIT for transparents instead of sorting
+static size_t kExtractPiecesPerWorker = 4; // BVH subtrees per worker for each culling query
 
 // CSM controls
 static int   kNumCascades       = 2;
@@ -104,8 +115,10 @@ out vec3 vWPos;
 out vec4 vLS0;
 out vec4 vLS1;
 out vec4 vLS2;
+out vec4 vTint;
 
 void main(){
+    vTint = vec4(1.0);
     mat3 nmat = mat3(transpose(inverse(matModel)));
     vN = normalize(nmat * vertexNormal);
     vec4 worldPos = matModel * vec4(vertexPosition,1.0);
@@ -130,6 +143,8 @@ in vec3 vertexNormal;
 
 // Per-instance model matrix provided as vertex attribute
 in mat4 instanceTransform;
+// Per-instance color/alpha (white when not streamed)
+in vec4 instanceTint;
 
 uniform mat4 mvp;
 uniform mat4 lightVP0;
@@ -145,8 +160,10 @@ out vec3 vWPos;
 out vec4 vLS0;
 out vec4 vLS1;
 out vec4 vLS2;
+out vec4 vTint;
 
 void main(){
+    vTint = instanceTint;
     mat3 nmat = mat3(transpose(inverse(instanceTransform)));
     vN = normalize(nmat * vertexNormal);
 
@@ -171,8 +188,10 @@ in vec3 vWPos;
 in vec4 vLS0;
 in vec4 vLS1;
 in vec4 vLS2;
+in vec4 vTint;
 
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out vec4 OitWeight;   // only bound during the OIT accumulation pass
 
 uniform vec3 viewPos;
 
@@ -212,6 +231,9 @@ uniform float exposure;       // new exposure control
 // raylib default material color (tint * material diffuse)
 uniform vec4 colDiffuse;
 
+// 1 while accumulating weighted blended OIT
+uniform int oitPass;
+
 float SampleShadow(sampler2DShadow smap, vec3 proj, float ndl){
     float bias = mix(biasMax, biasMin, ndl);
     float step = pcfStep / float(shadowMapResolution);
@@ -307,7 +329,8 @@ void main(){
     float shadow = ShadowBlend(p0, p1, p2, ndl, viewDepth, cascadeSplits);
 
     // Convert material color from sRGB to linear before lighting
-    vec3 base = pow(colDiffuse.rgb, vec3(2.2));
+    vec4 tint = colDiffuse * vTint;
+    vec3 base = pow(tint.rgb, vec3(2.2));
 
     // Diffuse sunlight contribution
     float sunTerm = sunStrength * ndl * shadow;
@@ -325,7 +348,31 @@ void main(){
 
     // Gamma correct (linear -> sRGB)
     color = pow(max(color, vec3(0.0)), vec3(1.0/2.2));
-    FragColor = vec4(color, colDiffuse.a);
+
+    if (oitPass == 1) {
+        // weighted blended OIT (McGuire/Bavoil): rgb += c*a*w, a *= (1-a), weight += a*w
+        float a = tint.a;
+        float w = clamp(pow(min(1.0, a*10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z*0.9, 3.0), 1e-2, 3e3);
+        FragColor = vec4(color * a * w, a);
+        OitWeight = vec4(a * w);
+    } else {
+        FragColor = vec4(color, tint.a);
+        OitWeight = vec4(0.0);
+    }
+})";
+
+// ---------------- OIT composite ----------------
+static const char* OIT_COMPOSITE_FS = R"(#version 330
+in vec2 fragTexCoord;
+out vec4 finalColor;
+uniform sampler2D texture0;   // accum: rgb = sum(c*a*w), a = prod(1-a)
+uniform sampler2D weightTex;  // r = sum(a*w)
+void main(){
+    vec4 accum = texture(texture0, fragTexCoord);
+    float reveal = accum.a;
+    if (reveal >= 1.0) discard;
+    float wsum = texture(weightTex, fragTexCoord).r;
+    finalColor = vec4(accum.rgb / max(wsum, 1e-5), 1.0 - reveal);
 })";
 
 // ---------------- Sky shader ----------------
@@ -366,8 +413,30 @@ static Shader gSkyShader   = {0};
 static Model  gPartModel   = {0}; // cube model used for parts
 static Model  gSkyModel    = {0};
 static Material gPartMatInst = {0};
+static Shader gOitCompositeShader = {};
 static RenderTexture2D gShadowMapCSM[3] = { {0},{0},{0} };
 
+// Light camera the cascade was last rendered with; contents are reused while it holds
+struct CascadeCache { bool valid{false}; Camera3D cam{}; };
+static CascadeCache gCascadeCache[3];
+static std::vector<AABB> gTouchedBounds;   // part bounds changed since the previous frame
+static DepthSorter gTransparentSorter;
+
+// Weighted blended OIT targets. With OIT on, the main pass renders offscreen so the
+// accumulation target can share its depth texture.
+struct OitTargets {
+    int w{0}, h{0};
+    RenderTexture2D scene{};    // RGBA8 + depth
+    RenderTexture2D accum{};    // RGBA16F accum (+ weight in 'weight'), same depth
+    Texture2D weight{};         // R16F
+};
+static OitTargets gOit;
+
+// Retained proxies for the workspace being drawn
+static RenderScene gScene;
+static std::weak_ptr<Workspace> gSceneWs;
+static size_t gSceneRemoveId = 0;
+
 // Sky uniforms
 static int u_inner=-1, u_outer=-1, u_transition=-1;
 
@@ -395,6 +464,8 @@ static int ui_splits=-1;
 static int ui_exposure=-1;
 static int ui_normalBias0=-1, ui_normalBias1=-1, ui_normalBias2=-1;
 static int ui_transition = -1;
+static int ui_oitPass = -1;
+static int u_oitWeightTex = -1;
 
 // ---------------- Shadowmap helpers ----------------
 static RenderTexture2D LoadShadowmapRenderTexture(int width, int height){
@@ -424,54 +495,6 @@ static void UnloadShadowmapRenderTexture(RenderTexture2D target){
     if (target.id > 0) rlUnloadFramebuffer(target.id);
 }
 
-// --------- CFrame -> axis-angle (for DrawModelEx) ----------
-static inline float clampf(float x, float a, float b){ return x < a ? a : (x > b ? b : x); }
-
-static void CFrameToAxisAngle(const CFrame& cf, ::Vector3& axisOut, float& angleDegOut){
-    // Row-major 3x3
-    const float m00 = cf.R[0], m01 = cf.R[1], m02 = cf.R[2];
-    const float m10 = cf.R[3], m11 = cf.R[4], m12 = cf.R[5];
-    const float m20 = cf.R[6], m21 = cf.R[7], m22 = cf.R[8];
-
-    const float trace = m00 + m11 + m22;
-    float cosA = (trace - 1.0f)*0.5f;
-    cosA = clampf(cosA, -1.0f, 1.0f);
-    float angle = acosf(cosA);
-
-    if (angle < 1e-6f){
-        axisOut = {0.0f, 1.0f, 0.0f};
-        angleDegOut = 0.0f;
-        return;
-    }
-
-    if (fabsf(PI - angle) < 1e-4f){
-        // Near 180°, robust axis extraction
-        float xx = sqrtf(fmaxf(0.0f, (m00 + 1.0f)*0.5f));
-        float yy = sqrtf(fmaxf(0.0f, (m11 + 1.0f)*0.5f));
-        float zz = sqrtf(fmaxf(0.0f, (m22 + 1.0f)*0.5f));
-        // pick signs from off-diagonals
-        xx = copysignf(xx, m21 - m12);
-        yy = copysignf(yy, m02 - m20);
-        zz = copysignf(zz, m10 - m01);
-        float len = sqrtf(xx*xx + yy*yy + zz*zz);
-        if (len < 1e-6f) { axisOut = {0.0f,1.0f,0.0f}; angleDegOut = 180.0f; return; }
-        axisOut = { xx/len, yy/len, zz/len };
-        angleDegOut = 180.0f;
-        return;
-    }
-
-    float s = 2.0f*sinf(angle);
-    ::Vector3 axis = {
-        (m21 - m12) / s,
-        (m02 - m20) / s,
-        (m10 - m01) / s
-    };
-    float len = sqrtf(axis.x*axis.x + axis.y*axis.y + axis.z*axis.z);
-    if (len < 1e-6f) { axisOut = {0.0f,1.0f,0.0f}; angleDegOut = 0.0f; return; }
-    axisOut = { axis.x/len, axis.y/len, axis.z/len };
-    angleDegOut = angle * (180.0f/PI);
-}
-
 // ---------------- Dynamic shadow helpers ----------------
 
 // Return a safe 'up' vector for the given direction
@@ -516,7 +539,16 @@ static inline Vector3 XformPoint(const Matrix& m, Vector3 p){
     return { x, y, z };
 }
 
-// Build a directional light camera tightly fitting the camera frustum slice
+// View-projection BeginMode3D produces for an orthographic light camera on an rtW x rtH target
+static Matrix LightCameraViewProj(const Camera3D& cam, int rtW, int rtH){
+    const float top   = cam.fovy * 0.5f;
+    const float right = top * ((float)rtW / (float)rtH);
+    Matrix view = MatrixLookAt(cam.position, cam.target, cam.up);
+    Matrix proj = MatrixOrtho(-right, right, -top, top, rlGetCullDistanceNear(), rlGetCullDistanceFar());
+    return MatrixMultiply(view, proj);
+}
+
+// Build a directional light camera fitting the camera frustum slice
 // NOTE: outTexelWS returns the world-space size of one shadow map texel for this cascade.
 static void BuildLightCameraForSlice(const Camera3D& cam, Vector3 sunDir,
                                      float sliceNear, float sliceFar,
@@ -533,28 +565,40 @@ static void BuildLightCameraForSlice(const Camera3D& cam, Vector3 sunDir,
     for (int i=0;i<8;i++) center = Vector3Add(center, cornersWS[i]);
     center = Vector3Scale(center, 1.0f/8.0f);
 
-    Vector3 upL = SafeUpForDir(Vector3Scale(sunDir, -1.0f));
-    // initial view from sun direction
-    Matrix lightView = MatrixLookAt(Vector3Add(center, Vector3Scale(Vector3Scale(sunDir, -1.0f), 200.0f)), center, upL);
-
-    // compute bounds in light space
-    Vector3 mn = { FLT_MAX, FLT_MAX, FLT_MAX };
-    Vector3 mx = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
-    for (int i=0;i<8;i++){
-        Vector3 p = XformPoint(lightView, cornersWS[i]);
-        mn.x = fminf(mn.x, p.x); mn.y = fminf(mn.y, p.y); mn.z = fminf(mn.z, p.z);
-        mx.x = fmaxf(mx.x, p.x); mx.y = fmaxf(mx.y, p.y); mx.z = fmaxf(mx.z, p.z);
-    }
+    const Vector3 toSun = Vector3Scale(sunDir, -1.0f);
+    Vector3 upL = SafeUpForDir(toSun);
+    // light-space basis anchored at the world origin, so snapping below is translation-stable
+    Matrix lightView = MatrixLookAt(toSun, Vector3{0,0,0}, upL);
 
-    // extents and aspect
-    float halfW = 0.5f*(mx.x - mn.x);
-    float halfH = 0.5f*(mx.y - mn.y);
     const float aspectRT = (float)rtW / (float)rtH;
-    float orthoHalfY = fmaxf(halfH, halfW / aspectRT);
-    float orthoHalfX = orthoHalfY * aspectRT;
+    float orthoHalfX, orthoHalfY;
+    if (kStabilizeShadow) {
+        // bounding sphere: extents no longer depend on camera orientation
+        float radius = 0.0f;
+        for (int i=0;i<8;i++) radius = fmaxf(radius, Vector3Distance(center, cornersWS[i]));
+        radius = ceilf(radius * 16.0f) / 16.0f;
+        orthoHalfY = fmaxf(radius, radius / aspectRT);
+        orthoHalfX = orthoHalfY * aspectRT;
+    } else {
+        // tight bounds in light space
+        Vector3 mn = { FLT_MAX, FLT_MAX, FLT_MAX };
+        Vector3 mx = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+        for (int i=0;i<8;i++){
+            Vector3 p = XformPoint(lightView, cornersWS[i]);
+            mn.x = fminf(mn.x, p.x); mn.y = fminf(mn.y, p.y);
+            mx.x = fmaxf(mx.x, p.x); mx.y = fmaxf(mx.y, p.y);
+        }
+        float halfW = 0.5f*(mx.x - mn.x);
+        float halfH = 0.5f*(mx.y - mn.y);
+        orthoHalfY = fmaxf(halfH, halfW / aspectRT);
+        orthoHalfX = orthoHalfY * aspectRT;
+        // fit the box center rather than the centroid
+        Vector3 boxLS = { (mn.x + mx.x) * 0.5f, (mn.y + mx.y) * 0.5f, XformPoint(lightView, center).z };
+        center = XformPoint(MatrixInvert(lightView), boxLS);
+    }
 
     // center in light space
-    Vector3 centerLS = { (mn.x + mx.x) * 0.5f, (mn.y + mx.y) * 0.5f, (mn.z + mx.z) * 0.5f };
+    Vector3 centerLS = XformPoint(lightView, center);
 
     // texel snap
     float texelW = (2.0f * orthoHalfX) / (float)shadowRes;
@@ -570,29 +614,77 @@ static void BuildLightCameraForSlice(const Camera3D& cam, Vector3 sunDir,
     Matrix invView = MatrixInvert(lightView);
     Vector3 snappedCenterWS = XformPoint(invView, centerLS);
 
-    // final view
-    lightView = MatrixLookAt(Vector3Add(snappedCenterWS, Vector3Scale(Vector3Scale(sunDir, -1.0f), 200.0f)), snappedCenterWS, upL);
-
-    // depth range padded - tightened from 50 to 10
-    const float zNear = -mx.z - 10.0f;
-    const float zFar  = -mn.z + 10.0f;
-
-    Matrix lightProj = MatrixOrtho(-orthoHalfX, +orthoHalfX, -orthoHalfY, +orthoHalfY, zNear, zFar);
-
-    outLightVP = MatrixMultiply(lightView, lightProj);
-
     // fill Camera3D for BeginMode3D
     outCam = {0};
     outCam.projection = CAMERA_ORTHOGRAPHIC;
     outCam.up = upL;
     outCam.target = snappedCenterWS;
-    outCam.position = Vector3Add(snappedCenterWS, Vector3Scale(Vector3Scale(sunDir, -1.0f), 200.0f));
+    outCam.position = Vector3Add(snappedCenterWS, Vector3Scale(toSun, kShadowCasterReach));
     // raylib's ortho via fovy behaves differently: set fovy to full half-height to match our ortho extents
     outCam.fovy = orthoHalfY * 2.0f;
 
+    outLightVP = LightCameraViewProj(outCam, rtW, rtH);
     outTexelWS = texelWS;
 }
 
+// ---------------- OIT targets ----------------
+static void UnloadOitTargets(){
+    if (gOit.accum.id) rlUnloadFramebuffer(gOit.accum.id);   // also frees the shared depth texture
+    if (gOit.scene.id) rlUnloadFramebuffer(gOit.scene.id);
+    if (gOit.accum.texture.id) rlUnloadTexture(gOit.accum.texture.id);
+    if (gOit.weight.id) rlUnloadTexture(gOit.weight.id);
+    if (gOit.scene.texture.id) rlUnloadTexture(gOit.scene.texture.id);
+    gOit = OitTargets{};
+}
+
+// Returns false (and leaves OIT off) if the targets can't be built
+static bool EnsureOitTargets(int w, int h){
+    if (gOit.scene.id && gOit.w == w && gOit.h == h) return true;
+    UnloadOitTargets();
+
+    auto makeTex = [](int w, int h, int format){
+        Texture2D t = {};
+        t.id = rlLoadTexture(nullptr, w, h, format, 1);
+        t.width = w; t.height = h; t.mipmaps = 1; t.format = format;
+        return t;
+    };
+
+    Texture2D depth = {};
+    depth.id = rlLoadTextureDepth(w, h, false);
+    depth.width = w; depth.height = h; depth.mipmaps = 1;
+    depth.format = 19; // DEPTH24
+
+    gOit.w = w; gOit.h = h;
+    gOit.scene.id      = rlLoadFramebuffer();
+    gOit.scene.texture = makeTex(w, h, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    gOit.scene.depth   = depth;
+    rlFramebufferAttach(gOit.scene.id, gOit.scene.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+    rlFramebufferAttach(gOit.scene.id, depth.id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+
+    gOit.accum.id      = rlLoadFramebuffer();
+    gOit.accum.texture = makeTex(w, h, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16);
+    gOit.accum.depth   = depth;
+    gOit.weight        = makeTex(w, h, PIXELFORMAT_UNCOMPRESSED_R16);
+    rlFramebufferAttach(gOit.accum.id, gOit.accum.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+    rlFramebufferAttach(gOit.accum.id, gOit.weight.id, RL_ATTACHMENT_COLOR_CHANNEL1, RL_ATTACHMENT_TEXTURE2D, 0);
+    rlFramebufferAttach(gOit.accum.id, depth.id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+    rlEnableFramebuffer(gOit.accum.id);
+    rlActiveDrawBuffers(2);
+    rlDisableFramebuffer();
+
+    if (!rlFramebufferComplete(gOit.scene.id) || !rlFramebufferComplete(gOit.accum.id)) {
+        LOGW("Renderer: weighted OIT targets unavailable, falling back to sorted transparency");
+        UnloadOitTargets();
+        kWeightedOIT = false;
+        return false;
+    }
+    return true;
+}
+
+void SetWeightedOIT(bool enabled){
+    kWeightedOIT = enabled;
+}
+
 // ---------------- Init ----------------
 static void EnsureShaders() {
     if (!gLitShader.id) {
@@ -656,6 +748,9 @@ static void EnsureShaders() {
         // in order for DrawMeshInstanced to pick up instanceTransform as the model matrix attribute,
         // assign its attribute location to SHADER_LOC_MATRIX_MODEL
         gLitShaderInst.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(gLitShaderInst, "instanceTransform");
+        // per-instance tint rides on the vertex color slot (DrawMeshInstancedBuffer feeds it)
+        gLitShaderInst.locs[SHADER_LOC_VERTEX_COLOR] = GetShaderLocationAttrib(gLitShaderInst, "instanceTint");
+        ui_oitPass = GetShaderLocation(gLitShaderInst, "oitPass");
 
         // lighting (instanced)
         ui_viewPos   = GetShaderLocation(gLitShaderInst, "viewPos");
@@ -704,6 +799,11 @@ static void EnsureShaders() {
         SetShaderValue(gLitShaderInst, ui_exposure, &kExposure, SHADER_UNIFORM_FLOAT);
     }
 
+    if (!gOitCompositeShader.id) {
+        gOitCompositeShader = LoadShaderFromMemory(nullptr, OIT_COMPOSITE_FS);
+        u_oitWeightTex = GetShaderLocation(gOitCompositeShader, "weightTex");
+    }
+
     if (!gSkyShader.id) {
         gSkyShader = LoadShaderFromMemory(SKY_VS, SKY_FS);
         u_inner = GetShaderLocation(gSkyShader, "innerColor");
@@ -749,28 +849,33 @@ static inline void ComputeCascadeSplits(float n, float f, float lambda, float ou
     }
 }
 
-// ---------------- Helper: Build instance matrix ----------------
-static inline Matrix BuildInstanceMatrix(const CFrame& cf, ::Vector3 size){
-    // CFrame::R is row-major 3x3 as used above
-    const float m00 = cf.R[0], m01 = cf.R[1], m02 = cf.R[2];
-    const float m10 = cf.R[3], m11 = cf.R[4], m12 = cf.R[5];
-    const float m20 = cf.R[6], m21 = cf.R[7], m22 = cf.R[8];
-    ::Vector3 t = cf.p.toRay();
-
-    Matrix M = {0};
-    // column 0 = Sx * R[:,0]
-    M.m0 = m00*size.x; M.m1 = m10*size.x; M.m2 = m20*size.x; M.m3 = 0.0f;
-    // column 1 = Sy * R[:,1]
-    M.m4 = m01*size.y; M.m5 = m11*size.y; M.m6 = m21*size.y; M.m7 = 0.0f;
-    // column 2 = Sz * R[:,2]
-    M.m8 = m02*size.z; M.m9 = m12*size.z; M.m10= m22*size.z; M.m11= 0.0f;
-    // column 3 = translation
-    M.m12 = t.x; M.m13 = t.y; M.m14 = t.z; M.m15 = 1.0f;
-    return M;
+// ---------------- Helper: keep gScene attached to the live workspace ----------------
+// New parts arrive through FlushPartChanges (PartChange_Added); removals drop
+// the proxy right away since the part may not outlive the frame.
+static void BindSceneToWorkspace(const std::shared_ptr<Workspace>& ws){
+    auto bound = gSceneWs.lock();
+    if (ws && bound == ws) return; // still attached
+    if (bound) bound->Disconnect(gSceneRemoveId);
+    gScene.Clear();
+    // cached shadow maps hold the old workspace's casters
+    for (auto& cache : gCascadeCache) cache.valid = false;
+    gTouchedBounds.clear();
+    gSceneWs = ws;
+    if (!ws) return;
+
+    gSceneRemoveId = ws->OnDescendantRemoved([](const std::shared_ptr<Instance>& c){
+        if (c->Class == InstanceClass::Part) gScene.Remove(static_cast<BasePart*>(c.get()));
+    });
+    for (const auto& p : ws->parts) if (p) gScene.Add(p.get());
 }
 
 // ---------------- Main render ----------------
+static double gRenderSeconds = 0.0;
+
+double GetRenderSeconds() { return gRenderSeconds; }
+
 void RenderFrame(Camera3D& camera) {
+    const double renderStart = GetTime();
     if (IsKeyPressed(KEY_F11)) {
         static bool borderless=false; borderless=!borderless;
         if (borderless) EnterBorderlessFullscreen(); else ExitBorderlessFullscreen();
@@ -778,15 +883,13 @@ void RenderFrame(Camera3D& camera) {
 
     EnsureShaders();
 
-    // Camera + culling
+    // Camera frustum (same projection BeginMode3D builds for the main pass)
     const Vector3 camPos = camera.position;
-    Vector3 camDir = Vector3Normalize(Vector3Subtract(camera.target, camPos));
-    const float maxDistSq = kMaxDrawDistance * kMaxDrawDistance;
-    const float vFov = camera.fovy * (PI/180.0f);
-    const float aspect = (float)GetScreenWidth()/(float)GetScreenHeight();
-    const float hFov = 2.0f * atanf(tanf(vFov*0.5f)*aspect);
-    const float halfCone = 0.5f * ((hFov>vFov)?hFov:vFov) + kFovPaddingDeg*(PI/180.0f);
-    const float cosHalf2 = cosf(halfCone)*cosf(halfCone); // kept for reference
+    const float aspect  = (float)GetScreenWidth()/(float)GetScreenHeight();
+    const float farClip = fminf((float)rlGetCullDistanceFar(), kMaxDrawDistance);
+    const Matrix camView = MatrixLookAt(camera.position, camera.target, camera.up);
+    const Matrix camProj = MatrixPerspective(camera.fovy*DEG2RAD, aspect, rlGetCullDistanceNear(), farClip);
+    const Frustum camFrustum = Frustum::FromViewProjection(MatrixMultiply(camView, camProj));
 
     // Lighting params
     Vector3 sunDirV = kUseClockTime
@@ -804,38 +907,19 @@ void RenderFrame(Camera3D& camera) {
     float aoStr     = 0.6f;
     float groundY   = 0.5f;
 
-    // Gather parts
+    // Apply part changes to the retained scene before anything reads it
     auto ws = g_game ? g_game->workspace : nullptr;
-    struct TItem { std::shared_ptr<Part> p; float dist2; float alpha; };
-    std::vector<std::shared_ptr<Part>> opaques;
-    std::vector<TItem> transparents;
+    auto& batches = gScene.Batches();
 
+    BindSceneToWorkspace(ws);
     if (ws) {
-        for (const auto& p : ws->parts) {
-            if (!p || !p->Alive) continue;
-
-            // CF position
-            Vector3 pos = p->CF.p.toRay();
-            Vector3 delta = Vector3Subtract(pos, camPos);
-            float d2 = LenSq(delta);
-            if (d2 > maxDistSq) continue;
-
-            float dist = sqrtf(d2);
-            float cosTheta = Vector3DotProduct(camDir, delta) / (dist > 0 ? dist : 1.0f);
-
-            // size-based bounding sphere radius
-            float radius = 0.5f * Vector3Length(p->Size);
-
-            // allow hit if center is inside cone OR sphere overlaps cone boundary
-            float angleLimit = cosf(halfCone);
-            // if (cosTheta < angleLimit && dist * 0.5f > radius) continue;
-
-            float t = Clamp(p->Transparency, 0.0f, 1.0f);
-            float a = 1.0f - t;
-            if (a <= 0.0f) continue;
-            if (a >= 1.0f) opaques.push_back(p);
-            else transparents.push_back({p, d2, a});
-        }
+        static std::vector<RenderScene::Change> changes;
+        changes.clear();
+        ws->FlushPartChanges(&gTouchedBounds, [](BasePart* p, uint32_t what){
+            if (what & PartChange_Added) gScene.Add(p);
+            else changes.push_back({ p, what });
+        });
+        gScene.UpdateMany(changes);
     }
 
     // ---------------- Shadow pass (3 cascades) ----------------
@@ -849,8 +933,9 @@ void RenderFrame(Camera3D& camera) {
     ComputeCascadeSplits(kCameraNear, kShadowMaxDistance, 0.6f, splitRaw);
     float splits[3] = { splitRaw[0], splitRaw[1], kShadowMaxDistance };
 
-    // build and render each cascade
+    // build each cascade's light camera
     float nearD = kCameraNear;
+    float sliceNear[3], sliceFar[3];
     for (int i=0;i<3;i++){
         float farD = splits[i];
         BuildLightCameraForSlice(
@@ -862,35 +947,177 @@ void RenderFrame(Camera3D& camera) {
             lightCam[i], lightVP[i],
             cascadeTexelWS[i]
         );
+        sliceNear[i] = nearD;
+        sliceFar[i] = farD;
         nearD = farD;
     }
 
-    // Build instance transforms for shadow casters (include opaques and transparents)
-    std::vector<Matrix> shadowXforms;
-    shadowXforms.reserve(opaques.size() + transparents.size());
-    for (auto& p : opaques) shadowXforms.push_back(BuildInstanceMatrix(p->CF, p->Size));
-    for (auto& it : transparents) shadowXforms.push_back(BuildInstanceMatrix(it.p->CF, it.p->Size));
+    // Work out which cascades need re-rendering, and the volume their casters come from
+    bool cascadeDirty[3] = { false, false, false };
+    Frustum casterFrustum[3];
+    for (int i=0;i<3;i++){
+        // side planes + near plane come straight from the light camera (near sits kShadowCasterReach
+        // toward the sun); the far plane is pulled in to the deepest receiver this cascade can shade
+        casterFrustum[i] = Frustum::FromViewProjection(lightVP[i]);
+        Vector3 recv[8];
+        GetFrustumCornersWS(camera, sliceNear[i], sliceFar[i] * (1.0f + kCascadeTransition), recv);
+        float maxAlongSun = -FLT_MAX;
+        for (int c=0;c<8;c++) maxAlongSun = fmaxf(maxAlongSun, Vector3DotProduct(sunDirV, recv[c]));
+        casterFrustum[i].planes[Frustum::Far] = { -sunDirV.x, -sunDirV.y, -sunDirV.z, maxAlongSun + 10.0f };
+
+        // reuse last frame's map if the light camera is identical and nothing it sees has changed
+        CascadeCache& cache = gCascadeCache[i];
+        bool dirty = !kCacheShadowMaps || !cache.valid
+            || memcmp(&cache.cam, &lightCam[i], sizeof(Camera3D)) != 0;
+        for (size_t t = 0; !dirty && t < gTouchedBounds.size(); ++t)
+            dirty = casterFrustum[i].Overlaps(gTouchedBounds[t]);
+        if (!dirty) continue;
+        cache.valid = true;
+        cache.cam = lightCam[i];
+        cascadeDirty[i] = true;
+    }
+
+    // ---------------- Render list extraction ----------------
+    // The camera query and every dirty cascade's caster query are split into BVH
+    // subtrees and run on the JobSystem; each worker fills its own lists, merged below.
+    struct TItem { Part* p; float dist2; float alpha; };
+    struct ExtractJob { int target; SpatialIndex::SubQuery from; };   // target: 0 camera, 1..3 cascade
+    struct WorkerLists {
+        std::vector<std::pair<int32_t, const float16*>> opaque;   // (batch, xform)
+        std::vector<TItem> transparent;
+        std::vector<const float16*> casters[3];
+    };
+    static std::vector<ExtractJob> jobs;
+    static std::vector<SpatialIndex::SubQuery> pieces;
+    static std::vector<WorkerLists> workerLists;
+    jobs.clear();
+    if (workerLists.size() != (size_t)JobSystem::Get().WorkerCount())
+        workerLists.resize((size_t)JobSystem::Get().WorkerCount());
+    for (auto& wl : workerLists) {
+        wl.opaque.clear();
+        wl.transparent.clear();
+        for (auto& c : wl.casters) c.clear();
+    }
+
+    if (ws) {
+        const size_t piecesPerQuery = (size_t)JobSystem::Get().WorkerCount() * kExtractPiecesPerWorker;
+        for (int t = 0; t < 4; ++t) {
+            if (t > 0 && !cascadeDirty[t - 1]) continue;
+            pieces.clear();
+            ws->partIndex.SplitQuery(t == 0 ? camFrustum : casterFrustum[t - 1], piecesPerQuery, pieces);
+            for (const auto& q : pieces) jobs.push_back({ t, q });
+        }
+
+        const SpatialIndex& index = ws->partIndex;
+        JobSystem::Get().ParallelFor(jobs.size(), 1, [&](size_t begin, size_t end, int worker){
+            WorkerLists& out = workerLists[worker];
+            for (size_t j = begin; j < end; ++j) {
+                const ExtractJob& job = jobs[j];
+                if (job.target == 0) {
+                    index.QueryFrom(camFrustum, job.from, [&](void* ud){
+                        Part* p = static_cast<Part*>(ud);
+                        if (!p->Alive) return;
+
+                        float t = Clamp(p->GetTransparency(), 0.0f, 1.0f);
+                        float a = 1.0f - t;
+                        if (a <= 0.0f) return;
+                        if (a >= 1.0f) {
+                            // opaque: mark visible in its persistent color batch
+                            const int32_t b = gScene.BatchOf(p);
+                            if (b >= 0) out.opaque.push_back({ b, &gScene.Xform(p) });
+                        }
+                        else if (p->proxy.render >= 0)
+                            out.transparent.push_back({p, LenSq(Vector3Subtract(p->GetPosition().toRay(), camPos)), a});
+                    });
+                } else {
+                    auto& casters = out.casters[job.target - 1];
+                    index.QueryFrom(casterFrustum[job.target - 1], job.from, [&](void* ud){
+                        Part* p = static_cast<Part*>(ud);
+                        if (!p->Alive || !p->GetCastShadow() || p->GetTransparency() >= 1.0f) return;
+                        if (p->proxy.render < 0) return;
+                        casters.push_back(&gScene.Xform(p));
+                    });
+                }
+            }
+        });
+    }
+
+    // merge: visible opaques into their batches, casters into the frame stream
+    std::vector<TItem> transparents;
+    for (const auto& wl : workerLists) {
+        for (const auto& [b, m] : wl.opaque) batches[b].visible.push_back(m);
+        transparents.insert(transparents.end(), wl.transparent.begin(), wl.transparent.end());
+    }
+    int casterFirst[3] = { 0, 0, 0 }, casterCount[3] = { 0, 0, 0 };
+    for (int i=0;i<3;i++){
+        if (!cascadeDirty[i]) continue;
+        casterFirst[i] = gScene.StreamSize();
+        for (const auto& wl : workerLists)
+            for (const float16* m : wl.casters[i]) gScene.PushStream(*m);
+        casterCount[i] = gScene.StreamSize() - casterFirst[i];
+    }
+
+    // Opaque color batches: mostly-visible batches draw their persistent buffer as is,
+    // sparse ones stream just the visible instances
+    struct BatchDraw { int32_t batch; int first; int count; bool persistent; };
+    std::vector<BatchDraw> opaqueDraws;
+    for (int32_t b = 0; b < (int32_t)batches.size(); ++b) {
+        auto& batch = batches[b];
+        if (batch.visible.empty()) continue;
+        const int total = (int)batch.xforms.size();
+        if ((int)batch.visible.size() * kDenseBatchRatio >= total) {
+            opaqueDraws.push_back({ b, 0, total, true });
+        } else {
+            const int first = gScene.StreamSize();
+            for (const float16* m : batch.visible) gScene.PushStream(*m);
+            opaqueDraws.push_back({ b, first, (int)batch.visible.size(), false });
+        }
+    }
+
+    // Transparents: one instanced draw with per-instance tint. Sorted back to front with a
+    // frame-coherent radix sort unless OIT makes the order irrelevant.
+    const bool useOIT = kWeightedOIT && !transparents.empty()
+        && EnsureOitTargets(GetScreenWidth(), GetScreenHeight());
+    std::vector<DepthSorter::Item> transOrder;
+    transOrder.reserve(transparents.size());
+    float maxDist = 0.0f;
+    for (const auto& it : transparents) maxDist = fmaxf(maxDist, it.dist2);
+    maxDist = sqrtf(maxDist);
+    for (uint32_t i = 0; i < (uint32_t)transparents.size(); ++i) {
+        const TItem& it = transparents[i];
+        if (it.p->proxy.render < 0) continue;
+        transOrder.push_back({ it.p->proxy.render, DepthSorter::BackToFrontKey(sqrtf(it.dist2), maxDist), i });
+    }
+    if (!useOIT) gTransparentSorter.Sort(transOrder);
+
+    const int transFirst = gScene.StreamSize();
+    for (const auto& o : transOrder) {
+        const TItem& it = transparents[o.payload];
+        gScene.PushStream(gScene.Xform(it.p), ToRaylibColor(it.p->GetColor(), it.alpha));
+    }
+    const int transCount = gScene.StreamSize() - transFirst;
+
+    // Changed slots + this frame's stream go up in one go
+    gScene.Upload();
 
     for (int i=0;i<3;i++){
+        if (!cascadeDirty[i]) continue;
+
         BeginTextureMode(gShadowMapCSM[i]);
             ClearBackground(WHITE); // depth cleared by BeginMode3D
             BeginMode3D(lightCam[i]);
 
-                // note: rlGetMatrixModelview/projection gives the matrices raylib used; update our lightVP
-                Matrix lightView = rlGetMatrixModelview();
-                Matrix lightProj = rlGetMatrixProjection();
-                lightVP[i] = MatrixMultiply(lightView, lightProj);
-
                 // disable backface culling for shadow pass to reduce acne
                 rlDisableBackfaceCulling();
 
                 // Cast shadows from both opaque and transparent geometry (as solid)
-                if (!shadowXforms.empty()) {
+                if (casterCount[i] > 0) {
                     // color doesn't matter; depth-only framebuffer will use depth
                     // ensure instanced material shader is active for drawing instanced meshes
                     gPartMatInst.shader = gLitShaderInst;
                     gPartMatInst.maps[MATERIAL_MAP_DIFFUSE].color = WHITE;
-                    DrawMeshInstanced(gPartModel.meshes[0], gPartMatInst, shadowXforms.data(), (int)shadowXforms.size());
+                    DrawMeshInstancedBuffer(gPartModel.meshes[0], gPartMatInst, gScene.StreamBuffer(),
+                                            casterFirst[i], casterCount[i]);
                 }
 
                 // re-enable culling to previous state
@@ -899,6 +1126,7 @@ void RenderFrame(Camera3D& camera) {
             EndMode3D();
         EndTextureMode();
     }
+    gTouchedBounds.clear();
 
     // after building shadow maps, set per-cascade normal-bias based on texel size
     // choose ~1.5 texels of world-space offset as default
@@ -916,6 +1144,13 @@ void RenderFrame(Camera3D& camera) {
 
     // ---------------- Main pass ----------------
     BeginDrawing();
+    if (useOIT) {
+        // accum/weight start at (0,0,0,1); the main pass then renders into the offscreen scene target
+        BeginTextureMode(gOit.accum);
+            ClearBackground(Color{0, 0, 0, 255});
+        EndTextureMode();
+        BeginTextureMode(gOit.scene);
+    }
     ClearBackground(RAYWHITE);
     BeginMode3D(camera);
 
@@ -946,7 +1181,7 @@ void RenderFrame(Camera3D& camera) {
     // Prepare per-frame uniform values
     float viewPosArr[3] = { camera.position.x, camera.position.y, camera.position.z };
     float splitVec[3] = { splits[0], splits[1], splits[2] };
-    float transitionFrac = 0.15f; // 0.05..0.25 typical; lower = tighter band
+    float transitionFrac = kCascadeTransition; // 0.05..0.25 typical; lower = tighter band
     float exposure = kExposure;
 
     // Helper to set per-frame uniforms for a shader (handles instanced vs non-instanced)
@@ -1009,61 +1244,86 @@ void RenderFrame(Camera3D& camera) {
     SetPerFrame(gLitShader, false);
     SetPerFrame(gLitShaderInst, true);
 
-    // --- Opaques: batch by color -> instanced draws ---
-    std::unordered_map<uint32_t, std::vector<Matrix>> batches;
-    batches.reserve(64);
-
-    auto pack = [](unsigned r,unsigned g,unsigned b,unsigned a)->uint32_t{
-        return (r<<24) | (g<<16) | (b<<8) | a;
-    };
-
-    for (auto& p : opaques) {
-        Color c = ToRaylibColor(p->Color, 1.0f);
-        uint32_t key = pack(c.r,c.g,c.b,c.a);
-        batches[key].push_back(BuildInstanceMatrix(p->CF, p->Size));
-    }
-
-    // Use instanced material/shader for opaque batches
-    if (!batches.empty()) {
+    // --- Opaques: persistent color batches -> instanced draws ---
+    if (!opaqueDraws.empty()) {
         // Ensure instanced material uses our instanced shader
         gPartMatInst.shader = gLitShaderInst;
 
-        for (auto& kv : batches) {
-            auto &xforms = kv.second;
-            if (xforms.empty()) continue;
-            uint32_t key = kv.first;
-            Color c = { (unsigned char)(key>>24), (unsigned char)(key>>16), (unsigned char)(key>>8), (unsigned char)(key&0xFF) };
-            gPartMatInst.maps[MATERIAL_MAP_DIFFUSE].color = c;
-            DrawMeshInstanced(gPartModel.meshes[0], gPartMatInst, xforms.data(), (int)xforms.size());
+        for (const auto& d : opaqueDraws) {
+            const auto& batch = batches[d.batch];
+            gPartMatInst.maps[MATERIAL_MAP_DIFFUSE].color = batch.color;
+            DrawMeshInstancedBuffer(gPartModel.meshes[0], gPartMatInst,
+                                    d.persistent ? batch.vbo : gScene.StreamBuffer(), d.first, d.count);
         }
     }
 
     // Transparencies (sorted back-to-front)
-    std::sort(transparents.begin(), transparents.end(),
-              [](const TItem& A, const TItem& B){ return A.dist2 > B.dist2; });
-    BeginBlendMode(BLEND_ALPHA);
-    rlDisableDepthMask();
-    for (auto& it : transparents) {
-        Color c = ToRaylibColor(it.p->Color, it.alpha);
-        Vector3 pos = it.p->CF.p.toRay();
-        Vector3 axis; float angleDeg;
-        CFrameToAxisAngle(it.p->CF, axis, angleDeg);
-        DrawModelEx(gPartModel, pos, axis, angleDeg, it.p->Size, c);
+    if (transCount > 0 && !useOIT) {
+        BeginBlendMode(BLEND_ALPHA);
+        rlDisableDepthMask();
+        gPartMatInst.shader = gLitShaderInst;
+        gPartMatInst.maps[MATERIAL_MAP_DIFFUSE].color = WHITE;
+        DrawMeshInstancedBuffer(gPartModel.meshes[0], gPartMatInst, gScene.StreamBuffer(),
+                                transFirst, transCount, gScene.StreamTintBuffer());
+        rlEnableDepthMask();
+        EndBlendMode();
     }
-    rlEnableDepthMask();
-    EndBlendMode();
 
     EndShaderMode();
 
     if (kCullBackFace) rlDisableBackfaceCulling();
 
     EndMode3D();
+
+    if (useOIT) {
+        EndTextureMode();
+
+        // Accumulate transparents against the opaque depth (test only, no writes)
+        BeginTextureMode(gOit.accum);
+            BeginMode3D(camera);
+                if (kCullBackFace) rlEnableBackfaceCulling();
+                rlDisableDepthMask();
+                rlSetBlendFactorsSeparate(RL_ONE, RL_ONE, RL_ZERO, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+                BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+                    int oitOn = 1, oitOff = 0;
+                    SetShaderValue(gLitShaderInst, ui_oitPass, &oitOn, SHADER_UNIFORM_INT);
+                    gPartMatInst.shader = gLitShaderInst;
+                    gPartMatInst.maps[MATERIAL_MAP_DIFFUSE].color = WHITE;
+                    DrawMeshInstancedBuffer(gPartModel.meshes[0], gPartMatInst, gScene.StreamBuffer(),
+                                            transFirst, transCount, gScene.StreamTintBuffer());
+                    SetShaderValue(gLitShaderInst, ui_oitPass, &oitOff, SHADER_UNIFORM_INT);
+                EndBlendMode();
+                rlEnableDepthMask();
+                if (kCullBackFace) rlDisableBackfaceCulling();
+            EndMode3D();
+        EndTextureMode();
+
+        // Resolve over the opaque image
+        const Rectangle flip = { 0.0f, 0.0f, (float)gOit.w, -(float)gOit.h };
+        BeginTextureMode(gOit.scene);
+            BeginShaderMode(gOitCompositeShader);
+                SetShaderValueTexture(gOitCompositeShader, u_oitWeightTex, gOit.weight);
+                BeginBlendMode(BLEND_ALPHA);
+                    DrawTextureRec(gOit.accum.texture, flip, Vector2{0, 0}, WHITE);
+                EndBlendMode();
+            EndShaderMode();
+        EndTextureMode();
+
+        DrawTextureRec(gOit.scene.texture, flip, Vector2{0, 0}, WHITE);
+    }
+
     DrawFPS(10,10);
+    gRenderSeconds = GetTime() - renderStart;
     EndDrawing();
+
+    gScene.EndFrame();
 }
 
 // ---------------- Optional cleanup ----------------
 void ShutdownRendererShadowResources(){
+    gScene.Release();
+    UnloadOitTargets();
+    if (gOitCompositeShader.id) { UnloadShader(gOitCompositeShader); gOitCompositeShader = {}; }
     for (int i=0;i<3;i++){
         if (gShadowMapCSM[i].id) { UnloadShadowmapRenderTexture(gShadowMapCSM[i]); gShadowMapCSM[i] = {0}; }
     }
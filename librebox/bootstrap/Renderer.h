@@ -3,4 +3,9 @@
 
 void InitRenderer();
 void ShutdownRenderer();
-void RenderFrame(Camera3D& camera);
\ No newline at end of file
+void RenderFrame(Camera3D& camera);
+// CPU time the last RenderFrame took before presenting (vsync wait excluded)
+double GetRenderSeconds();
+
+// Opt-in weighted blended order-independent transparency
+void SetWeightedOIT(bool enabled);
@@ -4,7 +4,9 @@
 // ================== Includes ==================
 
 #include "ScriptingAPI.h"
+#include "LuaAtoms.h"
 #include "bootstrap/Instance.h"
+#include "bootstrap/LuaScheduler.h"
 #include "Game.h"
 
 // Raylib
@@ -49,6 +51,7 @@ static LuaConnUD* checkConn(lua_State* L, int idx) {
 // Connection methods
 static int l_conn_disconnect(lua_State* L){
     auto* c = checkConn(L, 1);
+    Lua_CheckSerial(L, "Disconnect");
     if (c && c->sig) c->sig->Disconnect(c->id);
     return 0;
 }
@@ -89,6 +92,7 @@ static void ensure_connection_meta(lua_State* L){
 static int l_signal_connect(lua_State* L){
     auto* s = checkSignal(L, 1);
     luaL_checktype(L, 2, LUA_TFUNCTION);
+    Lua_CheckSerial(L, "Connect");
     lua_remove(L, 1);                 // remove 'self'; function shifts to index 1
     size_t id = s->sig->Connect(L, /*once*/false, /*parallel*/false);
 
@@ -99,9 +103,28 @@ static int l_signal_connect(lua_State* L){
     return 1;
 }
 
+// Callback runs desynchronized, in the parallel phase of the script's actor
+static int l_signal_connect_parallel(lua_State* L){
+    auto* s = checkSignal(L, 1);
+    luaL_checktype(L, 2, LUA_TFUNCTION);
+    Lua_CheckSerial(L, "ConnectParallel");
+    LuaScheduler* sched = LuaScheduler::From(L);
+    if (!sched || !sched->IsActor())
+        luaL_error(L, "ConnectParallel can only be used by a script that is a descendant of an Actor");
+    lua_remove(L, 1);
+    size_t id = s->sig->Connect(L, /*once*/false, /*parallel*/true);
+
+    void* mem = lua_newuserdata(L, sizeof(LuaConnUD));
+    new (mem) LuaConnUD{ s->sig, id };
+    luaL_getmetatable(L, "Librebox.Connection");
+    lua_setmetatable(L, -2);
+    return 1;
+}
+
 static int l_signal_once(lua_State* L){
     auto* s = checkSignal(L, 1);
     luaL_checktype(L, 2, LUA_TFUNCTION);
+    Lua_CheckSerial(L, "Once");
     lua_remove(L, 1);                 // remove 'self'; function now at index 1
     size_t id = s->sig->Connect(L, /*once*/true, /*parallel*/false);
 
@@ -114,6 +137,7 @@ static int l_signal_once(lua_State* L){
 
 static int l_signal_wait(lua_State* L){
     auto* s = checkSignal(L, 1);
+    Lua_CheckSerial(L, "Wait");
     return s->sig->Wait(L);       // yields; resumed with fired args
 }
 static int l_signal_gc(lua_State* L){ auto* s = checkSignal(L,1); if (s) s->~LuaSignalUD(); return 0; }
@@ -127,6 +151,7 @@ static void ensure_signal_meta(lua_State* L){
     if (luaL_newmetatable(L, "Librebox.Signal")) {
         lua_newtable(L);
         lua_pushcfunction(L, l_signal_connect, "Connect"); lua_setfield(L, -2, "Connect");
+        lua_pushcfunction(L, l_signal_connect_parallel, "ConnectParallel"); lua_setfield(L, -2, "ConnectParallel");
         lua_pushcfunction(L, l_signal_once,    "Once");    lua_setfield(L, -2, "Once");
         lua_pushcfunction(L, l_signal_wait,    "Wait");    lua_setfield(L, -2, "Wait");
         lua_setfield(L, -2, "__methods");
@@ -167,23 +192,113 @@ void Lua_PushSignal(lua_State* L, const std::shared_ptr<RTScriptSignal>& sig) {
 
 
 // ================== Lua <-> Instance ==================
+// Instances are userdata tagged LuaTag_Instance holding a shared_ptr; the VM
+// attaches the "Librebox.Instance" metatable and runs the destructor by tag.
+//
+// Each VM caches Instance* -> userdata in a weak-valued registry table, so an
+// Instance crossing into Lua again gets the same proxy: nothing is allocated
+// and == holds by identity. A live proxy keeps its Instance alive, so an
+// address cannot be reused while its entry exists; entries (and proxies of
+// destroyed Instances) go once the GC collects the proxy.
+static const char kInstanceCacheKey = 0;   // registry key, by address
+
+static void create_instance_cache(lua_State* L) {
+    lua_pushlightuserdata(L, (void*)&kInstanceCacheKey);
+    lua_newtable(L);
+    lua_newtable(L);
+    lua_pushstring(L, "v");
+    lua_setfield(L, -2, "__mode");
+    lua_setmetatable(L, -2);
+    lua_rawset(L, LUA_REGISTRYINDEX);
+}
+
 void Lua_PushInstance(lua_State* L, const std::shared_ptr<Instance>& inst) {
     if (!inst) { lua_pushnil(L); return; }
-    void* userdata = lua_newuserdata(L, sizeof(std::shared_ptr<Instance>));
+
+    lua_pushlightuserdata(L, (void*)&kInstanceCacheKey);
+    lua_rawget(L, LUA_REGISTRYINDEX);
+    const bool cached = lua_istable(L, -1);
+    if (cached) {
+        lua_pushlightuserdata(L, inst.get());
+        lua_rawget(L, -2);
+        if (lua_touserdatatagged(L, -1, LuaTag_Instance)) {
+            lua_remove(L, -2);   // cache table
+            return;
+        }
+        lua_pop(L, 1);
+    }
+
+    void* userdata = lua_newuserdatataggedwithmetatable(L, sizeof(std::shared_ptr<Instance>), LuaTag_Instance);
     new (userdata) std::shared_ptr<Instance>(inst);
-    luaL_getmetatable(L, "Librebox.Instance");
-    lua_setmetatable(L, -2);
+
+    if (cached) {
+        lua_pushlightuserdata(L, inst.get());
+        lua_pushvalue(L, -2);
+        lua_rawset(L, -4);
+    }
+    lua_remove(L, -2);   // cache table or the nil in its place
+}
+
+std::shared_ptr<Instance>* Lua_CheckInstance(lua_State* L, int idx) {
+    void* ud = lua_touserdatatagged(L, idx, LuaTag_Instance);
+    if (!ud) luaL_typeerror(L, idx, "Instance");
+    return static_cast<std::shared_ptr<Instance>*>(ud);
 }
 
 static std::shared_ptr<Instance>* l_check_instance(lua_State* L, int n) {
-    return static_cast<std::shared_ptr<Instance>*>(
-        luaL_checkudata(L, n, "Librebox.Instance"));
+    return Lua_CheckInstance(L, n);
+}
+
+void Lua_PushCopy(lua_State* to, lua_State* from, int idx) {
+    switch (lua_type(from, idx)) {
+    case LUA_TBOOLEAN:
+        lua_pushboolean(to, lua_toboolean(from, idx));
+        return;
+    case LUA_TNUMBER:
+        lua_pushnumber(to, lua_tonumber(from, idx));
+        return;
+    case LUA_TSTRING: {
+        size_t len = 0;
+        const char* str = lua_tolstring(from, idx, &len);
+        lua_pushlstring(to, str, len);
+        return;
+    }
+    case LUA_TVECTOR: {
+        const float* v = lua_tovector(from, idx);
+        lua_pushvector(to, v[0], v[1], v[2]);
+        return;
+    }
+    case LUA_TUSERDATA:
+        if (void* ud = lua_touserdatatagged(from, idx, LuaTag_Instance)) {
+            Lua_PushInstance(to, *static_cast<std::shared_ptr<Instance>*>(ud));
+            return;
+        }
+        if (void* ud = lb::luaL_testudata(from, idx, lb::Traits<Vector3Game>::MetaName())) {
+            lb::push(to, *static_cast<Vector3Game*>(ud));
+            return;
+        }
+        if (void* ud = lb::luaL_testudata(from, idx, lb::Traits<CFrame>::MetaName())) {
+            lb::push(to, *static_cast<CFrame*>(ud));
+            return;
+        }
+        if (void* ud = lb::luaL_testudata(from, idx, lb::Traits<Color3>::MetaName())) {
+            lb::push(to, *static_cast<Color3*>(ud));
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+    lua_pushnil(to);
 }
 
-static int l_instance_gc(lua_State* L) {
-    auto* inst = l_check_instance(L, 1);
-    if (inst) inst->~shared_ptr<Instance>();
-    return 0;
+void Lua_CheckSerial(lua_State* L, const char* what) {
+    if (LuaScheduler::InParallelPhase())
+        luaL_error(L, "%s is not allowed in parallel; call task.synchronize() first", what);
+}
+
+static void l_instance_dtor(lua_State*, void* ud) {
+    static_cast<std::shared_ptr<Instance>*>(ud)->~shared_ptr<Instance>();
 }
 
 static int l_instance_eq(lua_State* L) {
@@ -242,6 +357,7 @@ static bool read_attribute(lua_State* L, int idx, Attribute& out) {
             out = std::string(s, len);
             return true;
         }
+        case LUA_TVECTOR:
         case LUA_TUSERDATA: {
             const Vector3Game* v = lb::check<Vector3Game>(L, idx);
             out = v->toRay();
@@ -273,6 +389,7 @@ static bool read_attribute(lua_State* L, int idx, Attribute& out) {
 
 static int m_SetAttribute(lua_State* L) {
     auto* inst_ptr = l_check_instance(L, 1);
+    Lua_CheckSerial(L, "SetAttribute");
     if (!inst_ptr || !*inst_ptr || !(*inst_ptr)->Alive) return 0;
     auto inst = *inst_ptr;
     const char* name = luaL_checkstring(L, 2);
@@ -319,6 +436,7 @@ static int m_GetFullName(lua_State* L) {
 
 static int m_Destroy(lua_State* L) {
     auto* inst_ptr = l_check_instance(L, 1);
+    Lua_CheckSerial(L, "Destroy");
     if (!inst_ptr || !*inst_ptr) return 0;
     auto inst = *inst_ptr;
     inst->Destroy();
@@ -335,6 +453,7 @@ static int m_Destroy(lua_State* L) {
 // legacy compatibility function
 static int m_LegacyFunctionRemove(lua_State* L) {
     auto* inst_ptr = l_check_instance(L, 1);
+    Lua_CheckSerial(L, "Remove");
     if (inst_ptr && *inst_ptr) (*inst_ptr)->LegacyFunctionRemove();
     return 0;
 }
@@ -359,6 +478,63 @@ static int m_GetDescendants(lua_State* L) {
     return 1;
 }
 
+static int m_QueryDescendants(lua_State* L) {
+    auto* inst_ptr = l_check_instance(L, 1);
+    const char* className = luaL_checkstring(L, 2);
+    if (!inst_ptr || !*inst_ptr || !(*inst_ptr)->Alive) { lua_newtable(L); return 1; }
+    auto vec = (*inst_ptr)->QueryDescendants(className);
+    lua_createtable(L, (int)vec.size(), 0);
+    int i = 1;
+    for (auto& c : vec) { Lua_PushInstance(L, c); lua_rawseti(L, -2, i++); }
+    return 1;
+}
+
+// inst:AddTag(tag), or CollectionService:AddTag(inst, tag); same for the other tag methods.
+// Only the CollectionService takes the target as an argument.
+static std::shared_ptr<Instance> tag_target(lua_State* L, int& tagIdx) {
+    auto* self = l_check_instance(L, 1);
+    tagIdx = 2;
+    if (!self || !*self) return nullptr;
+    if ((*self)->Class == InstanceClass::CollectionService) { tagIdx = 3; return *l_check_instance(L, 2); }
+    return *self;
+}
+
+static int m_AddTag(lua_State* L) {
+    int tagIdx;
+    auto inst = tag_target(L, tagIdx);
+    const char* tag = luaL_checkstring(L, tagIdx);
+    Lua_CheckSerial(L, "AddTag");
+    if (inst && inst->Alive) inst->AddTag(tag);
+    return 0;
+}
+
+static int m_RemoveTag(lua_State* L) {
+    int tagIdx;
+    auto inst = tag_target(L, tagIdx);
+    const char* tag = luaL_checkstring(L, tagIdx);
+    Lua_CheckSerial(L, "RemoveTag");
+    if (inst && inst->Alive) inst->RemoveTag(tag);
+    return 0;
+}
+
+static int m_HasTag(lua_State* L) {
+    int tagIdx;
+    auto inst = tag_target(L, tagIdx);
+    const char* tag = luaL_checkstring(L, tagIdx);
+    lua_pushboolean(L, inst && inst->Alive && inst->HasTag(tag));
+    return 1;
+}
+
+static int m_GetTags(lua_State* L) {
+    int tagIdx;
+    auto inst = tag_target(L, tagIdx);
+    auto tags = inst && inst->Alive ? inst->GetTags() : std::vector<std::string>{};
+    lua_createtable(L, (int)tags.size(), 0);
+    int i = 1;
+    for (auto& t : tags) { lua_pushlstring(L, t.data(), t.size()); lua_rawseti(L, -2, i++); }
+    return 1;
+}
+
 static int m_IsA(lua_State* L) {
     auto* inst_ptr = l_check_instance(L, 1);
     if (!inst_ptr || !*inst_ptr || !(*inst_ptr)->Alive) { lua_pushboolean(L, 0); return 1; }
@@ -369,6 +545,7 @@ static int m_IsA(lua_State* L) {
 
 static int m_Clone(lua_State* L) {
     auto* inst_ptr = l_check_instance(L, 1);
+    Lua_CheckSerial(L, "Clone");
     if (!inst_ptr || !*inst_ptr || !(*inst_ptr)->Alive) { lua_pushnil(L); return 1; }
     Lua_PushInstance(L, (*inst_ptr)->Clone());
     return 1;
@@ -448,86 +625,107 @@ static int m_IsAncestorOf(lua_State* L) {
 
 static int m_ClearAllChildren(lua_State* L) {
     auto* self = l_check_instance(L, 1);
+    Lua_CheckSerial(L, "ClearAllChildren");
     if (self && *self && (*self)->Alive) (*self)->ClearAllChildren();
     return 0;
 }
 
 // ================== Property Access ==================
 
-static int l_instance_index(lua_State* L) {
-    auto* inst_ptr = l_check_instance(L, 1);
-    if (!inst_ptr || !*inst_ptr) { lua_pushnil(L); return 1; }
-
-    auto inst = *inst_ptr;
-    const char* key = luaL_checkstring(L, 2);
+// Instance methods by atom, for __namecall; filled by RegisterSharedLibreboxAPI
+static lua_CFunction gMethodByAtom[Atom_Count] = {};
 
+// Pushes inst[key] the way __index resolves it. Upvalue 1 of the calling
+// closure is the atom-indexed method table.
+static void push_member(lua_State* L, const std::shared_ptr<Instance>& inst, int atom, const char* key) {
     // Always readable, even if destroyed
-    if (key[0] == 'N' && std::strcmp(key, "Name") == 0) {
+    switch (atom) {
+    case Atom_Name:
         lua_pushstring(L, inst->Name.c_str());
-        return 1;
-    }
-    if (key[0] == 'C' && std::strcmp(key, "ClassName") == 0) {
+        return;
+    case Atom_ClassName: {
         std::string s = inst->GetClassName();
         lua_pushlstring(L, s.c_str(), s.size());
-        return 1;
+        return;
     }
-    if (key[0] == 'P' && std::strcmp(key, "Parent") == 0) {
+    case Atom_Parent:
         Lua_PushInstance(L, inst->Parent.lock());
-        return 1;
+        return;
+    default:
+        break;
     }
 
-    if (!inst->Alive) { lua_pushnil(L); return 1; }
+    if (!inst->Alive) { lua_pushnil(L); return; }
 
     // Delegate object-specific reads to the instance
-    if (inst->LuaGet(L, key)) return 1;
+    if (atom != Atom_None && inst->LuaGet(L, atom)) return;
 
     // Child by name
     if (auto child = inst->FindFirstChild(key)) {
         Lua_PushInstance(L, child);
-        return 1;
+        return;
     }
 
     // Methods
-    lua_getmetatable(L, 1);
-    lua_getfield(L, -1, "__methods");
-    lua_pushvalue(L, 2);
-    lua_rawget(L, -2);
-    if (lua_isfunction(L, -1)) {
-        lua_remove(L, -2);
-        lua_remove(L, -2);
-        return 1;
+    if (atom != Atom_None && gMethodByAtom[atom]) {
+        lua_rawgeti(L, lua_upvalueindex(1), atom + 1);
+        return;
     }
-    lua_pop(L, 2);
-
     lua_pushnil(L);
+}
+
+static int l_instance_index(lua_State* L) {
+    auto* inst_ptr = l_check_instance(L, 1);
+    if (!inst_ptr || !*inst_ptr) { lua_pushnil(L); return 1; }
+
+    int atom = Atom_None;
+    const char* key = lua_tostringatom(L, 2, &atom);
+    if (!key) key = luaL_checkstring(L, 2);
+
+    push_member(L, *inst_ptr, atom, key);
     return 1;
 }
 
+// obj:Method(...) without materializing the method value
+static int l_instance_namecall(lua_State* L) {
+    int atom = Atom_None;
+    const char* name = lua_namecallatom(L, &atom);
+    if (!name) luaL_error(L, "namecall without a method name");
+
+    if (atom != Atom_None && gMethodByAtom[atom]) return gMethodByAtom[atom](L);
+
+    // class-specific callables (game:GetService) go through the regular lookup
+    auto* inst_ptr = l_check_instance(L, 1);
+    if (!inst_ptr || !*inst_ptr) luaL_error(L, "attempt to call method '%s' on a null Instance", name);
+    const int nargs = lua_gettop(L);
+    push_member(L, *inst_ptr, atom, name);
+    if (!lua_isfunction(L, -1)) {
+        std::string cls = (*inst_ptr)->GetClassName();
+        luaL_error(L, "%s is not a valid member of %s", name, cls.c_str());
+    }
+    lua_insert(L, 1);
+    lua_call(L, nargs, LUA_MULTRET);
+    return lua_gettop(L);
+}
+
 static int l_instance_newindex(lua_State* L) {
     auto* inst_ptr = l_check_instance(L, 1);
+    Lua_CheckSerial(L, "Setting a property");
     if (!inst_ptr || !*inst_ptr || !(*inst_ptr)->Alive) return 0;
 
     auto inst = *inst_ptr;
-    const char* key = luaL_checkstring(L, 2);
+    int atom = Atom_None;
+    if (!lua_tostringatom(L, 2, &atom)) luaL_checkstring(L, 2);
 
+    switch (atom) {
     // Name
-    if (key[0] == 'N' && std::strcmp(key, "Name") == 0) {
-        const char* newName = luaL_checkstring(L, 3);
-        if (inst->Name != newName) {
-            if (auto p = inst->Parent.lock()) {
-                auto it = p->ChildrenByName.find(inst->Name);
-                if (it != p->ChildrenByName.end() && it->second.get() == inst.get()) {
-                    p->ChildrenByName.erase(it);
-                }
-                p->ChildrenByName[newName] = inst;
-            }
-            inst->Name = newName;
-        }
+    case Atom_Name: {
+        inst->SetName(luaL_checkstring(L, 3));
         return 0;
     }
 
     // Parent
-    if (key[0] == 'P' && std::strcmp(key, "Parent") == 0) {
+    case Atom_Parent:
         if (lua_isnil(L, 3)) {
             inst->SetParent(nullptr);
         } else {
@@ -535,24 +733,27 @@ static int l_instance_newindex(lua_State* L) {
             if (parent_ptr) inst->SetParent(*parent_ptr);
         }
         return 0;
-    }
 
     // ClassName writes
-    if (key[0] == 'C' && std::strcmp(key, "ClassName") == 0) {
+    case Atom_ClassName:
         luaL_error(L, "ClassName is read-only");
         return 0;
-    }
 
-    // Delegate object-specific writes to the instance
-    if (inst->LuaSet(L, key, 3)) return 0;
+    case Atom_None:
+        return 0;
 
-    return 0;
+    // Delegate object-specific writes to the instance
+    default:
+        inst->LuaSet(L, atom, 3);
+        return 0;
+    }
 }
 
 // ================== Instance API ==================
 
 static int l_Instance_new(lua_State* L) {
     const char* typeName = luaL_checkstring(L, 1);
+    Lua_CheckSerial(L, "Instance.new");
     LOGI("Lua Instance.new('%s')", typeName);
     Lua_PushInstance(L, Instance::New(typeName));
     return 1;
@@ -560,20 +761,21 @@ static int l_Instance_new(lua_State* L) {
 
 // ================== task.* and wait ==================
 
-extern std::shared_ptr<Game> g_game;
+// Every VM (the game's and each Actor's) has its own scheduler; threads
+// always go back to the one that owns them.
 
 // wait(seconds?) -> yields coroutine; scheduler resumes with the actual waited seconds
 static int l_wait(lua_State* L) {
     double seconds = luaL_optnumber(L, 1, 0.0);
     Script* self = (Script*)lua_getthreaddata(L);
-    if (g_game && g_game->luaScheduler) {
+    if (LuaScheduler* sched = LuaScheduler::From(L)) {
         if (self) {
-            if (seconds > 0.0) g_game->luaScheduler->SetWaitAbs(self, GetTime() + seconds);
-            else               g_game->luaScheduler->SetWaitNextFrame(self);
+            if (seconds > 0.0) sched->SetWaitAbs(self, GetTime() + seconds);
+            else               sched->SetWaitNextFrame(self);
         } else {
             // inside a task thread
-            if (seconds > 0.0) g_game->luaScheduler->SetTaskWaitAbs(L, GetTime() + seconds);
-            else               g_game->luaScheduler->SetTaskWaitNextFrame(L);
+            if (seconds > 0.0) sched->SetTaskWaitAbs(L, GetTime() + seconds);
+            else               sched->SetTaskWaitNextFrame(L);
         }
     }
     return lua_yield(L, 0);
@@ -586,18 +788,12 @@ static int l_task_wait(lua_State* L) {
 // task.spawn(func, ...)
 static int l_task_spawn(lua_State* L) {
     luaL_checktype(L, 1, LUA_TFUNCTION);
-    if (!g_game || !g_game->luaScheduler) { lua_pushnil(L); return 1; }
-
-    lua_State* LM = g_game->luaScheduler->GetMainState();
-    if (!LM) { lua_pushnil(L); return 1; }
-
-    // Create new thread on main state and sandbox it
-    lua_newthread(LM);
-    lua_State* co = lua_tothread(LM, -1);
-    luaL_sandboxthread(co);
-    int ref = lua_ref(LM, -1); // pops thread from LM
-    lua_pop(LM, 1);
-    
+    LuaScheduler* sched = LuaScheduler::From(L);
+    if (!sched || !sched->GetMainState()) { lua_pushnil(L); return 1; }
+
+    int ref = LUA_NOREF;
+    lua_State* co = sched->NewThread(ref);   // kept alive by ref; never pooled, script keeps the handle
+
     // Move function + args into the new thread
     int nstack = lua_gettop(L); // includes function
     lua_xmove(L, co, nstack);
@@ -605,11 +801,12 @@ static int l_task_spawn(lua_State* L) {
     if (argc < 0) argc = 0;
 
     // Schedule next frame with pending arg count
-    g_game->luaScheduler->ScheduleTaskNextFrame(co, ref, argc);
+    sched->ScheduleTaskNextFrame(co, ref, argc);
+    // started during a parallel phase: stays in parallel
+    if (LuaScheduler::InParallelPhase()) sched->SetThreadParallel(nullptr, co, true);
 
     // Return the thread object
-    lua_getref(LM, ref);
-    lua_xmove(LM, L, 1);
+    lua_getref(L, ref);
     return 1;
 }
 
@@ -617,80 +814,121 @@ static int l_task_spawn(lua_State* L) {
 static int l_task_delay(lua_State* L) {
     double seconds = luaL_checknumber(L, 1);
     luaL_checktype(L, 2, LUA_TFUNCTION);
-    if (!g_game || !g_game->luaScheduler) { lua_pushnil(L); return 1; }
-
-    lua_State* LM = g_game->luaScheduler->GetMainState();
-    if (!LM) { lua_pushnil(L); return 1; }
+    LuaScheduler* sched = LuaScheduler::From(L);
+    if (!sched || !sched->GetMainState()) { lua_pushnil(L); return 1; }
 
     // Remove seconds so stack = func, ...
     lua_remove(L, 1);
     int nstack = lua_gettop(L); // func + args
     int argc = nstack - 1; if (argc < 0) argc = 0;
 
-    // Create and sandbox thread
-    lua_newthread(LM);
-    lua_State* co = lua_tothread(LM, -1);
-    luaL_sandboxthread(co);
-    int ref = lua_ref(LM, -1);
-    lua_pop(LM, 1);
+    int ref = LUA_NOREF;
+    lua_State* co = sched->NewThread(ref);   // kept alive by ref; never pooled, script keeps the handle
 
     // Move func+args into the new thread
     lua_xmove(L, co, nstack);
 
     // Schedule for the future
-    g_game->luaScheduler->ScheduleTaskAt(co, ref, GetTime() + std::max(0.0, seconds), argc);
+    sched->ScheduleTaskAt(co, ref, GetTime() + std::max(0.0, seconds), argc);
+    if (LuaScheduler::InParallelPhase()) sched->SetThreadParallel(nullptr, co, true);
 
     // Return the thread
-    lua_getref(LM, ref);
-    lua_xmove(LM, L, 1);
+    lua_getref(L, ref);
     return 1;
 }
 
+// task.desynchronize() -> resumes in this frame's parallel phase
+static int l_task_desynchronize(lua_State* L) {
+    LuaScheduler* sched = LuaScheduler::From(L);
+    if (!sched || !sched->IsActor())
+        luaL_error(L, "task.desynchronize can only be called from a script that is a descendant of an Actor");
+    if (LuaScheduler::InParallelPhase()) return 0;
+    if (!sched->SetThreadParallel((BaseScript*)lua_getthreaddata(L), L, true))
+        luaL_error(L, "task.desynchronize: thread is not managed by the task scheduler");
+    return lua_yield(L, 0);
+}
+
+// task.synchronize() -> resumes in the next serial phase
+static int l_task_synchronize(lua_State* L) {
+    if (!LuaScheduler::InParallelPhase()) return 0;
+    LuaScheduler* sched = LuaScheduler::From(L);
+    if (!sched || !sched->SetThreadParallel((BaseScript*)lua_getthreaddata(L), L, false))
+        luaL_error(L, "task.synchronize: thread is not managed by the task scheduler");
+    return lua_yield(L, 0);
+}
+
 // ================== Global API Registration ==================
 
 void RegisterSharedLibreboxAPI(lua_State* L) {
     LOGI("Registering shared Librebox API");
 
+    // Property / method names resolve to LuaAtoms when the string is interned
+    lua_callbacks(L)->useratom = LuaAtomOf;
+
     // Instance metatable
     luaL_newmetatable(L, "Librebox.Instance");
 
+    struct MethodEntry { LuaAtom atom; lua_CFunction fn; };
+    static const MethodEntry kMethods[] = {
+        { Atom_SetAttribute,              m_SetAttribute },
+        { Atom_GetAttribute,              m_GetAttribute },
+        { Atom_GetAttributes,             m_GetAttributes },
+        { Atom_GetFullName,               m_GetFullName },
+        { Atom_Destroy,                   m_Destroy },
+        { Atom_GetChildren,               m_GetChildren },
+        { Atom_GetDescendants,            m_GetDescendants },
+        { Atom_FindFirstChild,            m_FindFirstChild },
+        { Atom_FindFirstChildOfClass,     m_FindFirstChildOfClass },
+        { Atom_FindFirstChildWhichIsA,    m_FindFirstChildWhichIsA },
+        { Atom_FindFirstAncestor,         m_FindFirstAncestor },
+        { Atom_FindFirstAncestorOfClass,  m_FindFirstAncestorOfClass },
+        { Atom_FindFirstAncestorWhichIsA, m_FindFirstAncestorWhichIsA },
+        { Atom_IsDescendantOf,            m_IsDescendantOf },
+        { Atom_IsAncestorOf,              m_IsAncestorOf },
+        { Atom_ClearAllChildren,          m_ClearAllChildren },
+        { Atom_Clone,                     m_Clone },
+        { Atom_IsA,                       m_IsA },
+        { Atom_QueryDescendants,          m_QueryDescendants },
+        { Atom_AddTag,                    m_AddTag },
+        { Atom_RemoveTag,                 m_RemoveTag },
+        { Atom_HasTag,                    m_HasTag },
+        { Atom_GetTags,                   m_GetTags },
+
+        // legacy functions for compat
+        { Atom_getChildren,               m_GetChildren },
+        { Atom_clone,                     m_Clone },
+        { Atom_Remove,                    m_LegacyFunctionRemove },
+        { Atom_remove,                    m_LegacyFunctionRemove },
+        { Atom_findFirstChild,            m_FindFirstChild },
+        { Atom_isDescendantOf,            m_IsDescendantOf },
+    };
+
+    // __methods by name (for rawget-style lookups) and by atom + 1 (for __index)
     lua_newtable(L);
-    lua_pushcfunction(L, m_SetAttribute, "SetAttribute"); lua_setfield(L, -2, "SetAttribute");
-    lua_pushcfunction(L, m_GetAttribute, "GetAttribute"); lua_setfield(L, -2, "GetAttribute");
-    lua_pushcfunction(L, m_GetAttributes,"GetAttributes");lua_setfield(L, -2, "GetAttributes");
-    lua_pushcfunction(L, m_GetFullName,  "GetFullName");  lua_setfield(L, -2, "GetFullName");
-    lua_pushcfunction(L, m_Destroy, "Destroy");           lua_setfield(L, -2, "Destroy");
-    lua_pushcfunction(L, m_GetChildren,   "GetChildren");   lua_setfield(L, -2, "GetChildren");
-    lua_pushcfunction(L, m_GetDescendants,"GetDescendants");lua_setfield(L, -2, "GetDescendants");
-    lua_pushcfunction(L, m_FindFirstChild,           "FindFirstChild");           lua_setfield(L, -2, "FindFirstChild");
-    lua_pushcfunction(L, m_FindFirstChildOfClass,    "FindFirstChildOfClass");    lua_setfield(L, -2, "FindFirstChildOfClass");
-    lua_pushcfunction(L, m_FindFirstChildWhichIsA,   "FindFirstChildWhichIsA");   lua_setfield(L, -2, "FindFirstChildWhichIsA");
-    lua_pushcfunction(L, m_FindFirstAncestor,        "FindFirstAncestor");        lua_setfield(L, -2, "FindFirstAncestor");
-    lua_pushcfunction(L, m_FindFirstAncestorOfClass, "FindFirstAncestorOfClass"); lua_setfield(L, -2, "FindFirstAncestorOfClass");
-    lua_pushcfunction(L, m_FindFirstAncestorWhichIsA,"FindFirstAncestorWhichIsA");lua_setfield(L, -2, "FindFirstAncestorWhichIsA");
-    lua_pushcfunction(L, m_IsDescendantOf,  "IsDescendantOf");  lua_setfield(L, -2, "IsDescendantOf");
-    lua_pushcfunction(L, m_IsAncestorOf,    "IsAncestorOf");    lua_setfield(L, -2, "IsAncestorOf");
-    lua_pushcfunction(L, m_ClearAllChildren,"ClearAllChildren");lua_setfield(L, -2, "ClearAllChildren");
-    lua_pushcfunction(L, m_Clone, "Clone"); lua_setfield(L, -2, "Clone");
-    lua_pushcfunction(L, m_IsA, "IsA"); lua_setfield(L, -2, "IsA");
-
-    // legacy functions for compat
-    lua_pushcfunction(L, m_GetChildren,   "getChildren");   lua_setfield(L, -2, "getChildren");
-    lua_pushcfunction(L, m_Clone, "clone"); lua_setfield(L, -2, "clone");
-    lua_pushcfunction(L, m_LegacyFunctionRemove, "Remove");          lua_setfield(L, -2, "Remove");
-    lua_pushcfunction(L, m_LegacyFunctionRemove, "remove");          lua_setfield(L, -2, "remove");
-    lua_pushcfunction(L, m_FindFirstChild, "findFirstChild");  lua_setfield(L, -2, "findFirstChild");
-    lua_pushcfunction(L, m_IsDescendantOf,  "isDescendantOf");  lua_setfield(L, -2, "isDescendantOf");
-
-    lua_setfield(L, -2, "__methods");   
-
-    lua_pushcfunction(L, l_instance_index,   "index");    lua_setfield(L, -2, "__index");
+    lua_createtable(L, Atom_Count, 0);
+    for (const auto& m : kMethods) {
+        const char* name = LuaAtomName(m.atom);
+        gMethodByAtom[m.atom] = m.fn;
+        lua_pushcfunction(L, m.fn, name);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, -4, name);
+        lua_rawseti(L, -2, m.atom + 1);
+    }
+    lua_pushvalue(L, -1);
+    lua_pushcclosure(L, l_instance_index, "index", 1); lua_setfield(L, -4, "__index");
+    lua_pushcclosure(L, l_instance_namecall, "namecall", 1); lua_setfield(L, -3, "__namecall");
+    lua_setfield(L, -2, "__methods");
+
     lua_pushcfunction(L, l_instance_newindex,"newindex"); lua_setfield(L, -2, "__newindex");
-    lua_pushcfunction(L, l_instance_gc,      "gc");       lua_setfield(L, -2, "__gc");
     lua_pushcfunction(L, l_instance_eq,      "eq");       lua_setfield(L, -2, "__eq");
     lua_pushcfunction(L, l_instance_tostring, "tostring");lua_setfield(L, -2, "__tostring");
 
+    // tagged Instance userdata pick up this metatable and destructor from the VM
+    lua_pushvalue(L, -1);
+    lua_setuserdatametatable(L, LuaTag_Instance);
+    lua_setuserdatadtor(L, LuaTag_Instance, l_instance_dtor);
     lua_pop(L, 1);
+    create_instance_cache(L);
 
     // Instance library
     lua_newtable(L);
@@ -700,6 +938,7 @@ void RegisterSharedLibreboxAPI(lua_State* L) {
 
     // Engine datatypes
     lb::register_type<Vector3Game>(L);
+    if (lb::NativeVector3()) lb::register_native_vector3(L);
     lb::register_type<CFrame>(L);
     lb::register_type<Color3>(L);
     lb::register_type<Random>(L);
@@ -713,5 +952,7 @@ void RegisterSharedLibreboxAPI(lua_State* L) {
     lua_pushcfunction(L, l_task_wait,  "wait");  lua_setfield(L, -2, "wait");
     lua_pushcfunction(L, l_task_spawn, "spawn"); lua_setfield(L, -2, "spawn");
     lua_pushcfunction(L, l_task_delay, "delay"); lua_setfield(L, -2, "delay");
+    lua_pushcfunction(L, l_task_desynchronize, "desynchronize"); lua_setfield(L, -2, "desynchronize");
+    lua_pushcfunction(L, l_task_synchronize,   "synchronize");   lua_setfield(L, -2, "synchronize");
     lua_setglobal(L, "task");
 }
@@ -7,6 +7,17 @@ struct Instance;
 
 void RegisterSharedLibreboxAPI(lua_State* L);
 
+// Userdata tags (lua_newuserdatatagged). Tagged userdata are type-checked by
+// tag and destroyed through lua_setuserdatadtor instead of a metatable lookup.
+enum LuaUserdataTag { LuaTag_Instance = 1 };
+
 // Utility used by scripts to pass Instances to Luau
 void Lua_PushInstance(lua_State* L, const std::shared_ptr<Instance>& inst);
-void Lua_PushSignal(lua_State* L, const std::shared_ptr<RTScriptSignal>& sig);
\ No newline at end of file
+// Instance userdata at 'idx', or raises a type error
+std::shared_ptr<Instance>* Lua_CheckInstance(lua_State* L, int idx);
+void Lua_PushSignal(lua_State* L, const std::shared_ptr<RTScriptSignal>& sig);
+// Pushes onto 'to' a copy of the value at 'idx' in another VM: primitives,
+// Instances and engine datatypes; anything else arrives as nil
+void Lua_PushCopy(lua_State* to, lua_State* from, int idx);
+// Raises a Lua error while the calling thread runs an actor's parallel phase
+void Lua_CheckSerial(lua_State* L, const char* what);
\ No newline at end of file
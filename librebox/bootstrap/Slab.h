@@ -0,0 +1,135 @@
+// ================== bootstrap/Slab.h ==================
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Generation-checked reference to a Slab record. A handle to a destroyed
+// record (even if its slot was reused) resolves to nullptr.
+struct SlabHandle {
+    uint32_t index{UINT32_MAX};
+    uint32_t generation{0};
+};
+
+// Pool of T records in fixed-size chunks. Records never move, so raw pointers
+// stay valid while a record is alive (TimerHeap relies on that), and once the
+// pool has grown, Create/Destroy only recycle slots. T must be
+// default-constructible; Create hands out a freshly reset record.
+template <typename T>
+class Slab {
+public:
+    SlabHandle Create() {
+        uint32_t index;
+        if (!freeSlots.empty()) { index = freeSlots.back(); freeSlots.pop_back(); }
+        else {
+            index = capacity;
+            if ((index & (kChunk - 1)) == 0) chunks.emplace_back(new Cell[kChunk]);
+            capacity++;
+        }
+        Cell& c = CellAt(index);
+        c.value = T{};
+        c.live  = true;
+        count++;
+        return { index, c.generation };
+    }
+
+    void Destroy(SlabHandle h) {
+        if (!Get(h)) return;
+        Cell& c = CellAt(h.index);
+        c.live = false;
+        c.generation++;
+        freeSlots.push_back(h.index);
+        count--;
+    }
+
+    T* Get(SlabHandle h) {
+        if (h.index >= capacity) return nullptr;
+        Cell& c = CellAt(h.index);
+        return (c.live && c.generation == h.generation) ? &c.value : nullptr;
+    }
+    const T* Get(SlabHandle h) const { return const_cast<Slab*>(this)->Get(h); }
+
+    // Direct slot access for indices taken from live records (SlabList links)
+    T& At(uint32_t index) { return CellAt(index).value; }
+    SlabHandle HandleAt(uint32_t index) const { return { index, CellAt(index).generation }; }
+    bool Live(uint32_t index) const { return index < capacity && CellAt(index).live; }
+
+    size_t Count() const { return count; }
+    // One past the highest slot ever used; iterate with Live()
+    uint32_t Capacity() const { return capacity; }
+
+private:
+    static constexpr uint32_t kChunk = 256;   // power of two
+
+    struct Cell {
+        T        value{};
+        uint32_t generation{0};
+        bool     live{false};
+    };
+
+    Cell& CellAt(uint32_t i) { return chunks[i / kChunk][i & (kChunk - 1)]; }
+    const Cell& CellAt(uint32_t i) const { return chunks[i / kChunk][i & (kChunk - 1)]; }
+
+    std::vector<std::unique_ptr<Cell[]>> chunks;
+    std::vector<uint32_t> freeSlots;
+    uint32_t capacity{0};
+    size_t   count{0};
+};
+
+// Links a Slab record into at most one SlabList
+struct SlabLink {
+    uint32_t prev{UINT32_MAX};
+    uint32_t next{UINT32_MAX};
+    const void* list{nullptr};   // owning SlabList, nullptr when unlinked
+};
+
+// Intrusive FIFO of slab indices threaded through each record's 'link'
+// member. Push, pop and removal of any member are O(1) and never allocate.
+template <typename T>
+class SlabList {
+public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    bool     Empty() const { return head == kNone; }
+    size_t   Size() const { return size; }
+    uint32_t Front() const { return head; }
+    bool     Contains(const T& r) const { return r.link.list == this; }
+
+    void PushBack(Slab<T>& slab, uint32_t index) {
+        T& r = slab.At(index);
+        r.link.prev = tail;
+        r.link.next = kNone;
+        r.link.list = this;
+        if (tail != kNone) slab.At(tail).link.next = index;
+        else head = index;
+        tail = index;
+        size++;
+    }
+
+    void Remove(Slab<T>& slab, uint32_t index) {
+        T& r = slab.At(index);
+        if (r.link.list != this) return;
+        if (r.link.prev != kNone) slab.At(r.link.prev).link.next = r.link.next;
+        else head = r.link.next;
+        if (r.link.next != kNone) slab.At(r.link.next).link.prev = r.link.prev;
+        else tail = r.link.prev;
+        r.link = SlabLink{};
+        size--;
+    }
+
+    uint32_t PopFront(Slab<T>& slab) {
+        const uint32_t index = head;
+        Remove(slab, index);
+        return index;
+    }
+
+    // Forget every member without touching their links; only valid when the
+    // records themselves are being discarded (scheduler shutdown)
+    void Reset() { head = tail = kNone; size = 0; }
+
+private:
+    uint32_t head{kNone};
+    uint32_t tail{kNone};
+    size_t   size{0};
+};
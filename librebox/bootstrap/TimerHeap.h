@@ -0,0 +1,98 @@
+// ================== bootstrap/TimerHeap.h ==================
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 4-ary min-heap of wake times over caller-owned nodes. Every node stores its
+// own position in 'heapIndex' (-1 when not queued), so re-arming a queued node
+// moves it in place and cancelling removes it directly: no duplicate entries,
+// no search, and comparisons only read the heap array. Nodes must not move in
+// memory while queued.
+template <typename Node>
+class TimerHeap {
+public:
+    bool   Empty() const { return heap.empty(); }
+    size_t Size() const { return heap.size(); }
+    double TopTime() const { return heap[0].time; }
+    Node*  Top() const { return heap[0].node; }
+
+    // Insert 'n', or move it if it is already queued
+    void Schedule(Node* n, double time) {
+        if (n->heapIndex >= 0) {
+            const size_t i = (size_t)n->heapIndex;
+            const double old = heap[i].time;
+            heap[i].time = time;
+            if (time < old) SiftUp(i); else SiftDown(i);
+            return;
+        }
+        heap.push_back({ time, n });
+        n->heapIndex = (int32_t)(heap.size() - 1);
+        SiftUp(heap.size() - 1);
+    }
+
+    void Cancel(Node* n) {
+        if (n->heapIndex < 0) return;
+        RemoveAt((size_t)n->heapIndex);
+    }
+
+    Node* Pop() {
+        Node* n = heap[0].node;
+        RemoveAt(0);
+        return n;
+    }
+
+    void Clear() {
+        for (Entry& e : heap) e.node->heapIndex = -1;
+        heap.clear();
+    }
+
+private:
+    static constexpr size_t kArity = 4;
+
+    struct Entry { double time; Node* node; };
+    std::vector<Entry> heap;
+
+    void Place(size_t i, const Entry& e) {
+        heap[i] = e;
+        e.node->heapIndex = (int32_t)i;
+    }
+
+    void RemoveAt(size_t i) {
+        heap[i].node->heapIndex = -1;
+        const Entry last = heap.back();
+        heap.pop_back();
+        if (i == heap.size()) return;
+        const double old = heap[i].time;
+        Place(i, last);
+        if (last.time < old) SiftUp(i); else SiftDown(i);
+    }
+
+    void SiftUp(size_t i) {
+        const Entry e = heap[i];
+        while (i > 0) {
+            const size_t parent = (i - 1) / kArity;
+            if (!(e.time < heap[parent].time)) break;
+            Place(i, heap[parent]);
+            i = parent;
+        }
+        Place(i, e);
+    }
+
+    void SiftDown(size_t i) {
+        const Entry e = heap[i];
+        const size_t n = heap.size();
+        for (;;) {
+            const size_t first = i * kArity + 1;
+            if (first >= n) break;
+            const size_t end = (first + kArity < n) ? first + kArity : n;
+            size_t best = first;
+            for (size_t c = first + 1; c < end; ++c)
+                if (heap[c].time < heap[best].time) best = c;
+            if (!(heap[best].time < e.time)) break;
+            Place(i, heap[best]);
+            i = best;
+        }
+        Place(i, e);
+    }
+};
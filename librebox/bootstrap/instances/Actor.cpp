@@ -0,0 +1,26 @@
+// instances/Actor.cpp
+#include "bootstrap/instances/Actor.h"
+#include "bootstrap/Game.h"
+#include "bootstrap/LuaScheduler.h"
+#include "core/logging/Logging.h"
+#include <utility>
+
+extern std::shared_ptr<Game> g_game;
+
+static Instance::Registrar _reg_actor("Actor", [] {
+    return Instance::Make<Actor>("Actor");
+});
+
+Actor::Actor(std::string name)
+    : Instance(std::move(name), InstanceClass::Actor) {}
+
+// An Actor dropped without Destroy() still gives up its VM
+Actor::~Actor() {
+    if (g_game && g_game->luaScheduler) g_game->luaScheduler->ReleaseActor(this);
+}
+
+void Actor::Destroy() {
+    // Scripts inside stop as their instances are destroyed; the VM goes after
+    Instance::Destroy();
+    if (g_game && g_game->luaScheduler) g_game->luaScheduler->ReleaseActor(this);
+}
@@ -0,0 +1,13 @@
+// instances/Actor.h
+#pragma once
+#include "bootstrap/Instance.h"
+#include <string>
+
+// Scripts under an Actor run in that actor's own Luau VM, so their
+// desynchronized work can run on the job system alongside other actors.
+struct Actor : Instance {
+    explicit Actor(std::string name = "Actor");
+    ~Actor() override;
+
+    void Destroy() override;
+};
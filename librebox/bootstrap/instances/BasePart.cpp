@@ -1,81 +1,52 @@
 #include "bootstrap/instances/BasePart.h"
+#include "bootstrap/instances/Workspace.h"
 #include "core/logging/Logging.h"
-#include <cstring>
+#include "bootstrap/LuaAtoms.h"
+#include "bootstrap/Reflection.h"
 #include <cmath>
 
 static inline float rad2deg(float r){ return r * 57.29577951308232f; }
 static inline float deg2rad(float d){ return d * 0.017453292519943295f; }
 
 BasePart::BasePart(std::string name, InstanceClass cls)
-    : Instance(std::move(name), cls), CF{} {
-    LOGI("BasePart created '%s' (Transparency=%.2f, Color=%.2f,%.2f,%.2f)", 
-         Name.c_str(), Transparency, Color.r, Color.g, Color.b);
-}
+    : Instance(std::move(name), cls), record(this) {}
 
 BasePart::~BasePart() = default;
 
-bool BasePart::LuaGet(lua_State* L, const char* key) const {
-    if (std::strcmp(key, "CFrame") == 0) {
-        lb::push(L, CF);
-        return true;
-    }
-    if (std::strcmp(key, "Position") == 0) {
-        lb::push(L, CF.p);
-        return true;
-    }
-    if (std::strcmp(key, "Orientation") == 0) {
-        float rx, ry, rz;
-        CF.toEulerAnglesXYZ(rx, ry, rz);
-        lb::push(L, Vector3Game{ rad2deg(rx), rad2deg(ry), rad2deg(rz) });
-        return true;
-    }
-    if (std::strcmp(key, "Size") == 0) {
-        lb::push(L, Vector3Game::fromRay(Size));
-        return true;
-    }
-    if (std::strcmp(key, "Transparency") == 0) {
-        lua_pushnumber(L, Transparency);
-        return true;
-    }
-    if (std::strcmp(key, "Color") == 0) {
-        lb::push(L, Color3{ Color.r, Color.g, Color.b });
-        return true;
-    }
-    return false;
+void BasePart::MarkChanged(uint32_t what) {
+    if (proxy.owner) proxy.owner->NotifyPartChanged(this, what);
+}
+
+Vector3Game BasePart::GetOrientation() const {
+    float rx, ry, rz;
+    GetCFrame().toEulerAnglesXYZ(rx, ry, rz);
+    return Vector3Game{ rad2deg(rx), rad2deg(ry), rad2deg(rz) };
 }
 
-bool BasePart::LuaSet(lua_State* L, const char* key, int valueIndex) {
-    if (std::strcmp(key, "CFrame") == 0) {
-        const auto* cf = lb::check<CFrame>(L, valueIndex);
-        CF = *cf;
-        return true;
-    }
-    if (std::strcmp(key, "Position") == 0) {
-        const auto* v = lb::check<Vector3Game>(L, valueIndex);
-        CF.p = *v;
-        return true;
-    }
-    if (std::strcmp(key, "Orientation") == 0) {
-        const auto* vdeg = lb::check<Vector3Game>(L, valueIndex);
-        CFrame rot = CFrame::fromEulerAnglesXYZ(
-            deg2rad(vdeg->x), deg2rad(vdeg->y), deg2rad(vdeg->z));
-        // replace rotation, keep translation
-        for(int i=0;i<9;i++) CF.R[i] = rot.R[i];
-        return true;
-    }
-    if (std::strcmp(key, "Size") == 0) {
-        const auto* v = lb::check<Vector3Game>(L, valueIndex);
-        Size = v->toRay();
-        return true;
-    }
-    if (std::strcmp(key, "Transparency") == 0) {
-        Transparency = (float)luaL_checknumber(L, valueIndex);
-        return true;
-    }
-    if (std::strcmp(key, "Color") == 0) {
-        const auto* c = lb::check<Color3>(L, valueIndex);
-        Color = { c->r, c->g, c->b };
-        return true;
-    }
-    return false;
+void BasePart::SetOrientation(const Vector3Game& degrees) {
+    CFrame rot = CFrame::fromEulerAnglesXYZ(deg2rad(degrees.x), deg2rad(degrees.y), deg2rad(degrees.z));
+    rot.p = GetPosition();
+    SetCFrame(rot);
 }
+
+// CFrame carries Position and Orientation, so only it is serialized
+static constexpr PropertyInfo kBasePartProps[] = {
+    Property<&BasePart::GetCFrame,       &BasePart::SetCFrame>(Atom_CFrame),
+    Property<&BasePart::GetPosition,     &BasePart::SetPosition>(Atom_Position, Prop_Replicate),
+    Property<&BasePart::GetOrientation,  &BasePart::SetOrientation>(Atom_Orientation, Prop_Replicate),
+    Property<&BasePart::GetSize,         &BasePart::SetSize>(Atom_Size),
+    Property<&BasePart::GetColor,        &BasePart::SetColor>(Atom_Color),
+    Property<&BasePart::GetTransparency, &BasePart::SetTransparency>(Atom_Transparency),
+    Property<&BasePart::GetCastShadow,   &BasePart::SetCastShadow>(Atom_CastShadow),
+    Property<&BasePart::GetAnchored,     &BasePart::SetAnchored>(Atom_Anchored),
+    Property<&BasePart::GetCanCollide,   &BasePart::SetCanCollide>(Atom_CanCollide),
+    Property<&BasePart::GetCanTouch,     &BasePart::SetCanTouch>(Atom_CanTouch),
+    Property<&BasePart::Reflectance>(Atom_Reflectance),
+    // physical properties; scripts will see them through CustomPhysicalProperties
+    Property<&BasePart::Density>(Atom_Density, Prop_Default | Prop_Hidden),
+    Property<&BasePart::Friction>(Atom_Friction, Prop_Default | Prop_Hidden),
+    Property<&BasePart::Elasticity>(Atom_Elasticity, Prop_Default | Prop_Hidden),
+};
+static constexpr PropertyTable kBasePartTable(kBasePartProps);
+
+const PropertyTable* BasePart::Properties() const { return &kBasePartTable; }
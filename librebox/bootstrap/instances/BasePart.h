@@ -3,33 +3,92 @@
 #include "core/datatypes/Vector3Game.h"
 #include "core/datatypes/CFrame.h"
 #include "core/datatypes/Color3.h"
+#include "bootstrap/instances/PartStore.h"
+#include <cstdint>
 
 // Forward declare Lua
 struct lua_State;
+struct Workspace;
 
-struct BasePart : Instance {
-    ::Vector3 Size{1.0f,1.0f,1.0f};
+// What changed on a part since the Workspace last consumed it
+enum PartChange : uint32_t {
+    PartChange_Bounds     = 1u << 0,   // CFrame / Size
+    PartChange_Visibility = 1u << 1,   // Transparency / CastShadow
+    PartChange_Color      = 1u << 2,
+    PartChange_Added      = 1u << 3,   // entered the Workspace; not in partIndex yet
+};
 
-    // Store transform internally as a CFrame (position + rotation)
-    CFrame CF; 
+// Bookkeeping owned by the Workspace the part lives in. Copies are
+// intentionally empty so Clone() never inherits another part's slots.
+struct PartProxy {
+    Workspace* owner{nullptr};
+    int32_t    slot{-1};       // index in Workspace::parts
+    int32_t    spatial{-1};    // leaf in Workspace::partIndex
+    int32_t    render{-1};     // proxy in the renderer's RenderScene
+    int32_t    changed{-1};    // index in Workspace::changedParts while dirty
+    uint32_t   dirty{0};       // pending PartChange bits
 
-    float Transparency{0.0f};
-    float Reflectance{0.0f};
+    PartProxy() = default;
+    PartProxy(const PartProxy&) {}
+    PartProxy& operator=(const PartProxy&) { return *this; }
+};
 
-    bool Anchored{false};
-    bool CanCollide{true};
-    bool CanTouch{true};
-    bool CastShadow{true};
+// The part's record in the PartStore. Copies copy the record's contents,
+// never the handle, so Clone() gets its own record.
+struct PartRecord {
+    PartHandle handle;
+
+    explicit PartRecord(BasePart* owner) : handle(PartStore::Get().Create(owner)) {}
+    PartRecord(const PartRecord&) = delete;
+    PartRecord& operator=(const PartRecord& o) {
+        PartStore::Get().CopyRecord(o.handle, handle);
+        return *this;
+    }
+    ~PartRecord() { PartStore::Get().Destroy(handle); }
+};
+
+struct BasePart : Instance {
+    // CFrame, Size, Color, Transparency and the collision/shadow flags live in
+    // the PartStore; go through the accessors below.
+    PartRecord record;
+
+    float Reflectance{0.0f};
 
     float Density{1.0f};
     float Friction{0.3f};
     float Elasticity{0.5f};
 
-    Color3 Color{0.63f, 0.63f, 0.63f}; // default white
+    PartProxy proxy;
 
     BasePart(std::string name, InstanceClass cls);
     ~BasePart() override;
 
-    bool LuaGet(lua_State* L, const char* key) const override;
-    bool LuaSet(lua_State* L, const char* key, int valueIndex) override;
+    // Setters raise the matching PartChange so the Workspace can refit its index
+    CFrame GetCFrame() const { return PartStore::Get().GetCFrame(record.handle); }
+    void   SetCFrame(const CFrame& cf) { PartStore::Get().SetCFrame(record.handle, cf); MarkChanged(PartChange_Bounds); }
+    Vector3Game GetPosition() const { return PartStore::Get().Position(record.handle); }
+    void   SetPosition(const Vector3Game& p) { PartStore::Get().Position(record.handle) = p; MarkChanged(PartChange_Bounds); }
+    // Euler XYZ in degrees; setting replaces the rotation and keeps the position
+    Vector3Game GetOrientation() const;
+    void   SetOrientation(const Vector3Game& degrees);
+    ::Vector3 GetSize() const { return PartStore::Get().Size(record.handle); }
+    void   SetSize(const ::Vector3& s) { PartStore::Get().Size(record.handle) = s; MarkChanged(PartChange_Bounds); }
+    Color3 GetColor() const { return PartStore::Get().Color(record.handle); }
+    void   SetColor(const Color3& c) { PartStore::Get().Color(record.handle) = c; MarkChanged(PartChange_Color); }
+    float  GetTransparency() const { return PartStore::Get().Transparency(record.handle); }
+    void   SetTransparency(float t) { PartStore::Get().Transparency(record.handle) = t; MarkChanged(PartChange_Visibility); }
+
+    bool GetAnchored() const   { return PartStore::Get().GetFlag(record.handle, PartFlag_Anchored); }
+    void SetAnchored(bool v)   { PartStore::Get().SetFlag(record.handle, PartFlag_Anchored, v); }
+    bool GetCanCollide() const { return PartStore::Get().GetFlag(record.handle, PartFlag_CanCollide); }
+    void SetCanCollide(bool v) { PartStore::Get().SetFlag(record.handle, PartFlag_CanCollide, v); }
+    bool GetCanTouch() const   { return PartStore::Get().GetFlag(record.handle, PartFlag_CanTouch); }
+    void SetCanTouch(bool v)   { PartStore::Get().SetFlag(record.handle, PartFlag_CanTouch, v); }
+    bool GetCastShadow() const { return PartStore::Get().GetFlag(record.handle, PartFlag_CastShadow); }
+    void SetCastShadow(bool v) { PartStore::Get().SetFlag(record.handle, PartFlag_CastShadow, v); MarkChanged(PartChange_Visibility); }
+
+    // Raised by the setters; the Workspace queues the part for its next flush
+    void MarkChanged(uint32_t what);
+
+    const PropertyTable* Properties() const override;
 };
@@ -32,7 +32,11 @@ void BaseScript::Schedule() {
 
     auto selfSp = std::static_pointer_cast<BaseScript>(shared_from_this());
 
-    g_game->luaScheduler->AddScript(
+    // Inside an Actor the script runs in that actor's VM
+    LuaScheduler* sched = g_game->luaScheduler.get();
+    if (auto actor = FindFirstAncestorOfClass("Actor")) sched = &sched->ActorScheduler(actor.get());
+
+    sched->AddScript(
         selfSp,
         Name,
         GetSource(),
@@ -47,7 +51,7 @@ void BaseScript::Schedule() {
 }
 
 void BaseScript::Destroy() {
-    // Cancel the coroutine if scheduled.
+    // Cancel the coroutine if scheduled (in whichever VM it runs).
     if (g_game && g_game->luaScheduler) {
         auto selfSp = std::static_pointer_cast<BaseScript>(shared_from_this());
         g_game->luaScheduler->StopScript(selfSp.get());
@@ -7,4 +7,4 @@ CameraGame::CameraGame(std::string name) : Instance(std::move(name), InstanceCla
 }
 CameraGame::~CameraGame() = default;
 
-static Instance::Registrar _reg_cam("Camera", []{ return std::make_shared<CameraGame>("Camera"); });
+static Instance::Registrar _reg_cam("Camera", []{ return Instance::Make<CameraGame>("Camera"); });
@@ -4,4 +4,5 @@
 #include "bootstrap/instances/Workspace.h"
 #include "bootstrap/instances/Script.h"
 #include "bootstrap/instances/LocalScript.h"
+#include "bootstrap/instances/Actor.h"
 // #include "bootstrap/instances/ModuleScript.h"
\ No newline at end of file
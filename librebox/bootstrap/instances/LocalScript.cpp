@@ -5,7 +5,7 @@
 #include <utility>
 
 static Instance::Registrar _reg_localscript("LocalScript", [] {
-    return std::make_shared<LocalScript>("LocalScript");
+    return Instance::Make<LocalScript>("LocalScript");
 });
 
 LocalScript::LocalScript(std::string name)
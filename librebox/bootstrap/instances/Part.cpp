@@ -3,12 +3,11 @@
 
 Part::Part(std::string name)
     : BasePart(std::move(name), InstanceClass::Part) {
-    Size = {4.0f, 1.0f, 2.0f};
-    LOGI("Part created '%s'", Name.c_str());
+    SetSize({4.0f, 1.0f, 2.0f});
 }
 
 Part::~Part() = default;
 
 static Instance::Registrar _reg_part("Part", [] {
-    return std::make_shared<Part>("Part");
+    return Instance::Make<Part>("Part");
 });
\ No newline at end of file
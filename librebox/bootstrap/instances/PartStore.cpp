@@ -0,0 +1,87 @@
+#include "bootstrap/instances/PartStore.h"
+#include <cstring>
+
+PartStore& PartStore::Get() {
+    // never destroyed: parts held by globals can outlive function statics at exit
+    static PartStore* store = new PartStore();
+    return *store;
+}
+
+PartHandle PartStore::Create(BasePart* owner) {
+    uint32_t index;
+    if (!freeSlots.empty()) { index = freeSlots.back(); freeSlots.pop_back(); }
+    else { index = (uint32_t)slots.size(); slots.push_back({ 0, 0 }); }
+
+    const uint32_t dense = (uint32_t)owners.size();
+    slots[index].dense = dense;
+    denseToSlot.push_back(index);
+
+    // BasePart defaults
+    const CFrame identity;
+    Rotation rot;
+    std::memcpy(rot.R, identity.R, sizeof(rot.R));
+    positions.push_back(identity.p);
+    rotations.push_back(rot);
+    sizes.push_back({ 1.0f, 1.0f, 1.0f });
+    colors.push_back({ 0.63f, 0.63f, 0.63f });
+    transparencies.push_back(0.0f);
+    flags.push_back(PartFlag_CanCollide | PartFlag_CanTouch | PartFlag_CastShadow);
+    owners.push_back(owner);
+
+    return { index, slots[index].generation };
+}
+
+void PartStore::Destroy(PartHandle h) {
+    if (!Valid(h)) return;
+    const uint32_t dense = slots[h.index].dense;
+    const uint32_t last = (uint32_t)owners.size() - 1;
+
+    // swap-remove from every array and repoint the moved record's slot
+    if (dense != last) {
+        positions[dense]      = positions[last];
+        rotations[dense]      = rotations[last];
+        sizes[dense]          = sizes[last];
+        colors[dense]         = colors[last];
+        transparencies[dense] = transparencies[last];
+        flags[dense]          = flags[last];
+        owners[dense]         = owners[last];
+        denseToSlot[dense]    = denseToSlot[last];
+        slots[denseToSlot[dense]].dense = dense;
+    }
+    positions.pop_back();
+    rotations.pop_back();
+    sizes.pop_back();
+    colors.pop_back();
+    transparencies.pop_back();
+    flags.pop_back();
+    owners.pop_back();
+    denseToSlot.pop_back();
+
+    slots[h.index].generation++;
+    freeSlots.push_back(h.index);
+}
+
+void PartStore::CopyRecord(PartHandle from, PartHandle to) {
+    if (!Valid(from) || !Valid(to)) return;
+    const uint32_t s = Dense(from), d = Dense(to);
+    positions[d]      = positions[s];
+    rotations[d]      = rotations[s];
+    sizes[d]          = sizes[s];
+    colors[d]         = colors[s];
+    transparencies[d] = transparencies[s];
+    flags[d]          = flags[s];
+}
+
+CFrame PartStore::GetCFrame(PartHandle h) const {
+    const uint32_t d = Dense(h);
+    CFrame cf;
+    std::memcpy(cf.R, rotations[d].R, sizeof(cf.R));
+    cf.p = positions[d];
+    return cf;
+}
+
+void PartStore::SetCFrame(PartHandle h, const CFrame& cf) {
+    const uint32_t d = Dense(h);
+    std::memcpy(rotations[d].R, cf.R, sizeof(cf.R));
+    positions[d] = cf.p;
+}
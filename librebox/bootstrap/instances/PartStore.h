@@ -0,0 +1,87 @@
+#pragma once
+#include "core/datatypes/Vector3Game.h"
+#include "core/datatypes/CFrame.h"
+#include "core/datatypes/Color3.h"
+#include <raylib.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+struct BasePart;
+
+// Stable reference to a record in the PartStore. Stays valid while the dense
+// arrays are compacted; a stale handle (record freed) fails Valid().
+struct PartHandle {
+    uint32_t index{UINT32_MAX};
+    uint32_t generation{0};
+};
+
+// Flag bits in PartStore::Flags()
+enum PartFlag : uint8_t {
+    PartFlag_Anchored   = 1u << 0,
+    PartFlag_CanCollide = 1u << 1,
+    PartFlag_CanTouch   = 1u << 2,
+    PartFlag_CastShadow = 1u << 3,
+};
+
+// Hot per-part state kept as dense structure-of-arrays, so whole-scene passes
+// (rendering, a physics step) stream contiguous memory instead of chasing
+// BasePart pointers. Records are swap-removed; handles go through a sparse
+// slot table. Main thread writes only; jobs may read between frames' writes.
+class PartStore {
+public:
+    struct Rotation { float R[9]; };   // row-major, as in CFrame
+
+    static PartStore& Get();
+
+    PartHandle Create(BasePart* owner);
+    void Destroy(PartHandle h);
+    bool Valid(PartHandle h) const {
+        return h.index < slots.size() && slots[h.index].generation == h.generation;
+    }
+    // Position of the record in the dense arrays; changes when others are destroyed
+    uint32_t Dense(PartHandle h) const { return slots[h.index].dense; }
+    // Copy every stored field from one record to another (Clone)
+    void CopyRecord(PartHandle from, PartHandle to);
+
+    size_t Count() const { return owners.size(); }
+
+    // Dense arrays, all Count() long and indexed alike
+    const std::vector<Vector3Game>& Positions() const { return positions; }
+    const std::vector<Rotation>&    Rotations() const { return rotations; }
+    const std::vector<::Vector3>&   Sizes() const { return sizes; }
+    const std::vector<Color3>&      Colors() const { return colors; }
+    const std::vector<float>&       Transparencies() const { return transparencies; }
+    const std::vector<uint8_t>&     Flags() const { return flags; }
+    const std::vector<BasePart*>&   Owners() const { return owners; }
+
+    // Per-record access through a handle
+    CFrame GetCFrame(PartHandle h) const;
+    void   SetCFrame(PartHandle h, const CFrame& cf);
+    Vector3Game& Position(PartHandle h) { return positions[Dense(h)]; }
+    Rotation&    Rot(PartHandle h) { return rotations[Dense(h)]; }
+    ::Vector3&   Size(PartHandle h) { return sizes[Dense(h)]; }
+    Color3&      Color(PartHandle h) { return colors[Dense(h)]; }
+    float&       Transparency(PartHandle h) { return transparencies[Dense(h)]; }
+    bool GetFlag(PartHandle h, PartFlag f) const { return (flags[Dense(h)] & f) != 0; }
+    void SetFlag(PartHandle h, PartFlag f, bool on) {
+        uint8_t& v = flags[Dense(h)];
+        v = on ? (uint8_t)(v | f) : (uint8_t)(v & ~f);
+    }
+
+private:
+    PartStore() = default;
+
+    struct Slot { uint32_t dense; uint32_t generation; };
+    std::vector<Slot>     slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> denseToSlot;
+
+    std::vector<Vector3Game> positions;
+    std::vector<Rotation>    rotations;
+    std::vector<::Vector3>   sizes;
+    std::vector<Color3>      colors;
+    std::vector<float>       transparencies;
+    std::vector<uint8_t>     flags;
+    std::vector<BasePart*>   owners;
+};
@@ -5,7 +5,7 @@
 #include <utility>
 
 static Instance::Registrar _reg_script("Script", [] {
-    return std::make_shared<Script>("Script", "");
+    return Instance::Make<Script>("Script", "");
 });
 
 Script::Script(std::string name)
@@ -1,28 +1,151 @@
 #include "bootstrap/instances/Workspace.h"
 #include "bootstrap/instances/Part.h"
 #include "bootstrap/instances/CameraGame.h"
+#include "bootstrap/ScriptingAPI.h"
+#include "bootstrap/LuaAtoms.h"
+#include "core/datatypes/LuaDatatypes.h"
+#include "lua.h"
+#include "lualib.h"
 #include <algorithm>
 
 Workspace::Workspace(std::string name)
     : Service(std::move(name), InstanceClass::Workspace) {
     OnDescendantAdded([this](const std::shared_ptr<Instance>& c){
-        if (c->Class == InstanceClass::Part)
-            parts.push_back(std::static_pointer_cast<Part>(c));
+        if (c->Class == InstanceClass::Part) {
+            auto sp = std::static_pointer_cast<Part>(c);
+            sp->proxy.owner   = this;
+            sp->proxy.slot    = (int32_t)parts.size();
+            parts.push_back(sp);
+            // partIndex and the renderer pick it up on the next flush
+            NotifyPartChanged(sp.get(), PartChange_Added);
+        }
         else if (c->Class == InstanceClass::Camera && !camera)
             camera = std::static_pointer_cast<CameraGame>(c);
     });
     OnDescendantRemoved([this](const std::shared_ptr<Instance>& c){
         if (c->Class == InstanceClass::Part) {
             auto sp = std::static_pointer_cast<Part>(c);
-            auto it = std::find(parts.begin(), parts.end(), sp);
-            if (it != parts.end()) { *it = parts.back(); parts.pop_back(); }
+            const int32_t slot = sp->proxy.slot;
+            if (slot >= 0 && (size_t)slot < parts.size() && parts[slot] == sp) {
+                if ((size_t)slot + 1 != parts.size()) {
+                    parts[slot] = std::move(parts.back());
+                    parts[slot]->proxy.slot = slot;
+                }
+                parts.pop_back();
+            }
+
+            if (sp->proxy.spatial >= 0) touchedBounds.push_back(partIndex.GetFatAABB(sp->proxy.spatial));
+            partIndex.Remove(sp->proxy.spatial);
+            const int32_t ct = sp->proxy.changed;
+            if (ct >= 0 && (size_t)ct < changedParts.size() && changedParts[ct] == sp.get()) {
+                if ((size_t)ct + 1 != changedParts.size()) {
+                    changedParts[ct] = changedParts.back();
+                    changedParts[ct]->proxy.changed = ct;
+                }
+                changedParts.pop_back();
+            }
+            sp->proxy.owner = nullptr;
+            sp->proxy.slot = -1;
+            sp->proxy.spatial = -1;
+            sp->proxy.changed = -1;
+            sp->proxy.dirty = 0;
         } else if (c->Class == InstanceClass::Camera) {
             if (camera && camera.get() == c.get()) camera.reset();
         }
     });
 }
-Workspace::~Workspace() = default;
+Workspace::~Workspace() {
+    for (auto& p : parts) if (p) p->proxy.owner = nullptr;
+}
+
+void Workspace::NotifyPartChanged(BasePart* p, uint32_t what) {
+    if (!p || p->proxy.owner != this) return;
+    if (!p->proxy.dirty) {
+        p->proxy.changed = (int32_t)changedParts.size();
+        changedParts.push_back(p);
+    }
+    p->proxy.dirty |= what;
+}
+
+void Workspace::FlushPartChanges(std::vector<AABB>* touched, const PartChangedFn& onChanged) {
+    if (touched) touched->insert(touched->end(), touchedBounds.begin(), touchedBounds.end());
+    touchedBounds.clear();
+
+    for (BasePart* p : changedParts) {
+        const uint32_t dirty = p->proxy.dirty;
+        p->proxy.dirty = 0;
+        p->proxy.changed = -1;
+        if (onChanged) onChanged(p, dirty);
+        if (dirty & PartChange_Added) {
+            // later changes in the same frame are already in the inserted box
+            const AABB box = ComputeBoxBounds(p->GetCFrame(), p->GetSize());
+            p->proxy.spatial = partIndex.Insert(box, p);
+            if (touched) touched->push_back(box);
+            continue;
+        }
+        if (!(dirty & (PartChange_Bounds | PartChange_Visibility))) continue;
+
+        // fat box before the refit still covers where the part was drawn last
+        if (touched) touched->push_back(partIndex.GetFatAABB(p->proxy.spatial));
+        if (dirty & PartChange_Bounds) {
+            const AABB box = ComputeBoxBounds(p->GetCFrame(), p->GetSize());
+            partIndex.Move(p->proxy.spatial, box);
+            if (touched) touched->push_back(box);
+        }
+    }
+    changedParts.clear();
+}
+
+// workspace:BulkMoveTo(parts, cframes): one call for a whole list of CFrame
+// writes; the partIndex refit still happens once, at the next flush
+static int l_workspace_bulkmoveto(lua_State* L) {
+    Lua_CheckInstance(L, 1);
+    Lua_CheckSerial(L, "BulkMoveTo");
+    luaL_checktype(L, 2, LUA_TTABLE);
+    luaL_checktype(L, 3, LUA_TTABLE);
+    const int n = lua_objlen(L, 2);
+    if (lua_objlen(L, 3) < n) luaL_error(L, "BulkMoveTo: expected %d CFrames", n);
+
+    for (int i = 1; i <= n; ++i) {
+        lua_rawgeti(L, 2, i);
+        lua_rawgeti(L, 3, i);
+        auto* inst = Lua_CheckInstance(L, -2);
+        if (!*inst || (*inst)->Class != InstanceClass::Part) luaL_error(L, "BulkMoveTo: item %d is not a BasePart", i);
+        const CFrame* cf = lb::check<CFrame>(L, -1);
+        if ((*inst)->Alive) static_cast<BasePart*>(inst->get())->SetCFrame(*cf);
+        lua_pop(L, 2);
+    }
+    return 0;
+}
+
+// workspace:BulkParent(instances, parent): sets Parent on every instance with
+// one DescendantAdded walk for the batch (Instance::SetParentAll)
+static int l_workspace_bulkparent(lua_State* L) {
+    Lua_CheckInstance(L, 1);
+    Lua_CheckSerial(L, "BulkParent");
+    luaL_checktype(L, 2, LUA_TTABLE);
+    std::shared_ptr<Instance> parent = lua_isnoneornil(L, 3) ? nullptr : *Lua_CheckInstance(L, 3);
+
+    const int n = lua_objlen(L, 2);
+    std::vector<std::shared_ptr<Instance>> children;
+    children.reserve(n);
+    for (int i = 1; i <= n; ++i) {
+        lua_rawgeti(L, 2, i);
+        children.push_back(*Lua_CheckInstance(L, -1));
+        lua_pop(L, 1);
+    }
+    Instance::SetParentAll(children, parent);
+    return 0;
+}
+
+bool Workspace::LuaGet(lua_State* L, int atom) const {
+    switch (atom) {
+    case Atom_BulkMoveTo: lua_pushcfunction(L, l_workspace_bulkmoveto, "BulkMoveTo"); return true;
+    case Atom_BulkParent: lua_pushcfunction(L, l_workspace_bulkparent, "BulkParent"); return true;
+    default: return Instance::LuaGet(L, atom);
+    }
+}
 
 static Instance::Registrar _reg_ws("Workspace", []{
-    return std::make_shared<Workspace>("Workspace");
-});
\ No newline at end of file
+    return Instance::Make<Workspace>("Workspace");
+});
@@ -1,15 +1,40 @@
 #pragma once
 #include "bootstrap/services/Service.h"
+#include "bootstrap/rendering/SpatialIndex.h"
 #include <vector>
 #include <memory>
+#include <functional>
+#include <cstdint>
 
 struct Part;
+struct BasePart;
 struct CameraGame;
 
 struct Workspace : Service {
     std::shared_ptr<CameraGame> camera;
-    std::vector<std::shared_ptr<Part>> parts;
+    std::vector<std::shared_ptr<Part>> parts;   // unordered; each part keeps its index in proxy.slot
+
+    // Bounding-volume tree over 'parts' (userData = Part*), refit lazily
+    SpatialIndex partIndex;
 
     explicit Workspace(std::string name = "Workspace");
     ~Workspace() override;
-};
\ No newline at end of file
+
+    // Queue a part whose PartChange bits were raised since the last flush
+    void NotifyPartChanged(BasePart* p, uint32_t what);
+    using PartChangedFn = std::function<void(BasePart*, uint32_t)>;
+
+    // Insert or refit partIndex for every queued part. Call once per frame before
+    // querying. Parts entering the Workspace are queued with PartChange_Added, so
+    // a part parented in and out between flushes never reaches partIndex.
+    // If 'touched' is given, it receives the old and new bounds of every part that
+    // was added, removed, moved or changed visibility since the previous flush.
+    // 'onChanged' sees each queued part with its accumulated PartChange bits.
+    void FlushPartChanges(std::vector<AABB>* touched = nullptr, const PartChangedFn& onChanged = nullptr);
+
+    bool LuaGet(lua_State* L, int atom) const override;
+
+private:
+    std::vector<BasePart*> changedParts;
+    std::vector<AABB> touchedBounds;   // from add/remove, handed out on flush
+};
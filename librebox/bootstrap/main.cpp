@@ -4,10 +4,12 @@
 #include "Game.h"
 #include "bootstrap/instances/Script.h"
 #include "core/logging/Logging.h"
+#include "core/datatypes/Vector3Game.h"
 #include "subsystems/filesystem/FileSystem.h"
 #include "instances/InstanceTypes.h"
 #include "services/RunService.h"
 #include "services/Lighting.h"
+#include "signals/Signal.h"
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
@@ -36,8 +38,11 @@ static float gYaw = 0.0f;
 static float gPitch = 0.0f;
 static bool gAnglesInit = false;
 static int gTargetFPS = 0;
+static int gGcGoal = 0;   // --gc-goal: fixed LUA_GCSETGOAL; 0 lets the pacer tune it
 static std::vector<std::string> gPaths;
+static std::vector<std::string> gActorPaths;   // --actor: each script in its own Actor
 static bool gNoPlace = false;
+static bool gMemoryReport = false;   // --memory-report: log Instance memory per class on exit
 static bool args = false;
 
 static void PhysicsSimulation() {
@@ -110,18 +115,30 @@ static void Stage_ConfigInitialization() {
     LOGI("Loaded configuration");
 }
 
-static void LoadAndScheduleScript(const std::string& name, const std::string& path) {
+static void LoadAndScheduleScript(const std::string& name, const std::string& path, bool inActor = false) {
     auto script = std::make_shared<Script>(name, fsys::ReadFileToString(path));
-    if (g_game && g_game->workspace) {
-        script->SetParent(g_game->workspace);
+    std::shared_ptr<Instance> parent = g_game ? g_game->workspace : nullptr;
+    if (inActor) {
+        auto actor = std::make_shared<Actor>(name);
+        if (parent) actor->SetParent(parent);
+        parent = actor;
+    }
+    if (parent) {
+        script->SetParent(parent);
     }
     script->Schedule();
     LOGI("Scheduled script: %s", path.c_str());
 }
 
 static bool Preflight_ValidatePaths() {
-    if (gPaths.empty()) return true;
+    if (gPaths.empty() && gActorPaths.empty()) return true;
     namespace fs = std::filesystem;
+    for (const auto& pathStr : gActorPaths) {
+        if (!fs::is_regular_file(pathStr)) {
+            LOGE("Actor script not found: %s", pathStr.c_str());
+            return false;
+        }
+    }
     for (const auto& pathStr : gPaths) {
         fs::path p(pathStr);
         if (!fs::exists(p)) {
@@ -179,6 +196,7 @@ static void Stage_Initialization() {
 
     g_game = std::make_shared<Game>();
     g_game->Init();
+    if (gGcGoal > 0 && g_game->luaScheduler) g_game->luaScheduler->SetGcGoal(gGcGoal);
 
     // load script if needed
     if (selected > 0) {
@@ -254,6 +272,11 @@ static void Stage_Initialization() {
         }
     }
 
+    for (const auto& pathStr : gActorPaths) {
+        const std::filesystem::path p(pathStr);
+        LoadAndScheduleScript(p.stem().string(), p.string(), /*inActor*/true);
+    }
+
     LOGI("Stage: Initialization end");
 }
 
@@ -337,6 +360,13 @@ static void Stage_Run() {
         g_camera.target   = Vector3Add(g_camera.position, forward);
         g_camera.up       = up;
 
+        // GC gets what is left of the frame, counting last frame's render time
+        if (g_game && g_game->luaScheduler) {
+            const int hz = gTargetFPS > 0 ? gTargetFPS : GetMonitorRefreshRate(GetCurrentMonitor());
+            const double frameSeconds = 1.0 / (hz > 0 ? hz : 60);
+            g_game->luaScheduler->StepGC(frameSeconds - (GetTime() - now) - GetRenderSeconds());
+        }
+
         RenderFrame(g_camera);
     }
 
@@ -346,6 +376,7 @@ static void Stage_Run() {
 static void Cleanup() {
     LOGI("Cleanup begin");
     if (g_game) {
+        if (gMemoryReport) Instance::LogMemoryReport(g_game);
         g_game->Shutdown();
         g_game.reset();
     }
@@ -360,8 +391,28 @@ int main(int argc, char** argv) {
         } else if (std::strcmp(argv[i], "--path") == 0 && i + 1 < argc) {
             gPaths.push_back(argv[++i]);
             args = true;
+        } else if (std::strcmp(argv[i], "--actor") == 0 && i + 1 < argc) {
+            gActorPaths.push_back(argv[++i]);
+            args = true;
         } else if (std::strcmp(argv[i], "--no-place") == 0) {
             gNoPlace = true;
+        } else if (std::strcmp(argv[i], "--memory-report") == 0) {
+            gMemoryReport = true;
+        } else if (std::strcmp(argv[i], "--oit") == 0) {
+            SetWeightedOIT(true);
+        } else if (std::strcmp(argv[i], "--native-vector3") == 0) {
+            lb::SetNativeVector3(true);
+        } else if (std::strcmp(argv[i], "--native") == 0) {
+            LuaScheduler::SetNativeCodegen(true);
+        } else if (std::strcmp(argv[i], "--bytecode-cache") == 0 && i + 1 < argc) {
+            LuaScheduler::SetBytecodeCacheDir(argv[++i]);
+        } else if (std::strcmp(argv[i], "--gc-goal") == 0 && i + 1 < argc) {
+            gGcGoal = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--signal-behavior") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            if (std::strcmp(mode, "immediate") == 0)     RTScriptSignal::SetBehavior(SignalBehavior::Immediate);
+            else if (std::strcmp(mode, "deferred") == 0) RTScriptSignal::SetBehavior(SignalBehavior::Deferred);
+            else LOGW("--signal-behavior: unknown mode '%s' (immediate|deferred)", mode);
         } else if (i == 1) {
             // first non-flag argument
             std::string arg = argv[i];
@@ -0,0 +1,76 @@
+// ================== bootstrap/rendering/DepthSort.cpp ==================
+#include "bootstrap/rendering/DepthSort.h"
+#include <algorithm>
+#include <cmath>
+
+// Insertion pass gives up after this many element moves per item
+static constexpr size_t kMaxMovesPerItem = 4;
+
+uint16_t DepthSorter::BackToFrontKey(float dist, float maxDist) {
+    if (!(maxDist > 0.0f)) return 0;
+    const float t = std::clamp(dist / maxDist, 0.0f, 1.0f);
+    return (uint16_t)(65535u - (uint32_t)std::lroundf(t * 65535.0f));
+}
+
+void DepthSorter::Sort(std::vector<Item>& items) {
+    const size_t n = items.size();
+    if (n < 2) {
+        lastCount = (uint32_t)n;
+        for (const Item& it : items) {
+            if ((size_t)it.id >= rank.size()) rank.resize((size_t)it.id + 1, 0);
+            rank[it.id] = 1;
+        }
+        return;
+    }
+
+    // 1) seed with last frame's order; unseen objects go after it
+    ordered.assign(lastCount, Item{ -1, 0, 0 });
+    newcomers.clear();
+    for (const Item& it : items) {
+        const uint32_t r = ((size_t)it.id < rank.size()) ? rank[it.id] : 0;
+        if (r && r <= lastCount && ordered[r - 1].id < 0) ordered[r - 1] = it;
+        else newcomers.push_back(it);
+    }
+    items.clear();
+    for (const Item& it : ordered) if (it.id >= 0) items.push_back(it);
+    items.insert(items.end(), newcomers.begin(), newcomers.end());
+
+    // 2) finish cheaply when coherent, otherwise radix
+    if (!InsertionSortBounded(items, n * kMaxMovesPerItem))
+        RadixSort(items);
+
+    // 3) remember the order for next frame
+    for (size_t i = 0; i < n; ++i) {
+        const int32_t id = items[i].id;
+        if ((size_t)id >= rank.size()) rank.resize((size_t)id + 1, 0);
+        rank[id] = (uint32_t)i + 1;
+    }
+    lastCount = (uint32_t)n;
+}
+
+bool DepthSorter::InsertionSortBounded(std::vector<Item>& items, size_t maxMoves) {
+    size_t moves = 0;
+    for (size_t i = 1; i < items.size(); ++i) {
+        const Item v = items[i];
+        size_t j = i;
+        while (j > 0 && items[j - 1].key > v.key) {
+            items[j] = items[j - 1];
+            --j;
+            if (++moves > maxMoves) { items[j] = v; return false; }
+        }
+        items[j] = v;
+    }
+    return true;
+}
+
+void DepthSorter::RadixSort(std::vector<Item>& items) {
+    // two stable 8-bit passes, low byte then high byte
+    scratch.resize(items.size());
+    for (int shift = 0; shift < 16; shift += 8) {
+        uint32_t count[257] = {};
+        for (const Item& it : items) count[((it.key >> shift) & 0xFF) + 1]++;
+        for (int b = 0; b < 256; ++b) count[b + 1] += count[b];
+        for (const Item& it : items) scratch[count[(it.key >> shift) & 0xFF]++] = it;
+        items.swap(scratch);
+    }
+}
@@ -0,0 +1,33 @@
+// ================== bootstrap/rendering/DepthSort.h ==================
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Orders transparent instances by a 16-bit key, reusing the previous frame's
+// order as the starting point. A static or slowly moving camera leaves the
+// list (nearly) sorted, which is finished with a bounded insertion pass;
+// anything messier falls back to a two-pass LSD radix sort.
+class DepthSorter {
+public:
+    struct Item {
+        int32_t  id;       // stable per-object id (>= 0) used to remember last frame's order
+        uint16_t key;      // ascending key = draw order
+        uint32_t payload;  // caller data, e.g. index into its own list
+    };
+
+    void Sort(std::vector<Item>& items);
+
+    // 16-bit key that draws far before near for distances in [0, maxDist]
+    static uint16_t BackToFrontKey(float dist, float maxDist);
+
+private:
+    std::vector<uint32_t> rank;       // id -> 1 + position last frame (0 = unseen)
+    uint32_t lastCount{0};
+    std::vector<Item> ordered;
+    std::vector<Item> newcomers;
+    std::vector<Item> scratch;
+
+    static bool InsertionSortBounded(std::vector<Item>& items, size_t maxMoves);
+    void RadixSort(std::vector<Item>& items);
+};
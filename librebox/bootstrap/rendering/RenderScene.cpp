@@ -0,0 +1,341 @@
+// ================== bootstrap/rendering/RenderScene.cpp ==================
+#include "bootstrap/rendering/RenderScene.h"
+#include "bootstrap/instances/BasePart.h"
+#include "bootstrap/JobSystem.h"
+#include <rlgl.h>
+#include <algorithm>
+#include <cmath>
+
+// Upload the whole batch instead of individual runs past this fraction of dirty slots
+static constexpr float kFullUploadFraction = 0.25f;
+// Changed parts per job when rebuilding matrices in parallel
+static constexpr size_t kRebuildGrain = 512;
+// Frames a color batch may stay empty before its buffer is freed
+static constexpr int kEmptyBatchFrames = 1;
+
+// ---------------- helpers ----------------
+static inline unsigned char ToByte(float v) {
+    return (unsigned char)std::lroundf(std::clamp(v, 0.0f, 1.0f) * 255.0f);
+}
+
+static inline uint32_t PackColor(Color c) {
+    return ((uint32_t)c.r << 24) | ((uint32_t)c.g << 16) | ((uint32_t)c.b << 8) | (uint32_t)c.a;
+}
+
+static inline bool IsOpaque(const BasePart* p) {
+    return std::clamp(p->GetTransparency(), 0.0f, 1.0f) <= 0.0f;
+}
+
+// Column-major instance matrix: columns are the scaled rotation axes and the position
+static float16 BuildInstanceXform(const CFrame& cf, ::Vector3 size) {
+    // CFrame::R is row-major 3x3
+    const ::Vector3 t = cf.p.toRay();
+    float16 m;
+    m.v[0]  = cf.R[0]*size.x; m.v[1]  = cf.R[3]*size.x; m.v[2]  = cf.R[6]*size.x; m.v[3]  = 0.0f;
+    m.v[4]  = cf.R[1]*size.y; m.v[5]  = cf.R[4]*size.y; m.v[6]  = cf.R[7]*size.y; m.v[7]  = 0.0f;
+    m.v[8]  = cf.R[2]*size.z; m.v[9]  = cf.R[5]*size.z; m.v[10] = cf.R[8]*size.z; m.v[11] = 0.0f;
+    m.v[12] = t.x;            m.v[13] = t.y;            m.v[14] = t.z;            m.v[15] = 1.0f;
+    return m;
+}
+
+// ---------------- proxies ----------------
+const RenderScene::Proxy* RenderScene::Find(const BasePart* p) const {
+    const int32_t id = p->proxy.render;
+    if (id < 0 || id >= (int32_t)proxies.size() || proxies[id].part != p) return nullptr;
+    return &proxies[id];
+}
+
+void RenderScene::Add(BasePart* p) {
+    if (!p || Find(p)) return;
+
+    int32_t id;
+    if (!freeProxies.empty()) { id = freeProxies.back(); freeProxies.pop_back(); }
+    else { id = (int32_t)proxies.size(); proxies.emplace_back(); }
+
+    Proxy& px = proxies[id];
+    px = Proxy{};
+    px.part  = p;
+    px.xform = BuildInstanceXform(p->GetCFrame(), p->GetSize());
+    p->proxy.render = id;
+    Attach(id);
+}
+
+void RenderScene::Remove(BasePart* p) {
+    if (!p || !Find(p)) return;
+    const int32_t id = p->proxy.render;
+    Detach(id);
+    proxies[id] = Proxy{};
+    freeProxies.push_back(id);
+    p->proxy.render = -1;
+}
+
+void RenderScene::Update(BasePart* p, uint32_t what) {
+    if (!p || !Find(p)) return;
+    const int32_t id = p->proxy.render;
+    Proxy& px = proxies[id];
+
+    if (what & PartChange_Bounds)
+        px.xform = BuildInstanceXform(p->GetCFrame(), p->GetSize());
+
+    if (what & (PartChange_Color | PartChange_Visibility)) {
+        // may change batch (or leave / join the opaque set)
+        Detach(id);
+        Attach(id);
+    } else if ((what & PartChange_Bounds) && px.batch >= 0) {
+        Batch& b = batches[px.batch];
+        b.xforms[px.slot] = px.xform;
+        MarkSlot(b, px.slot);
+    }
+}
+
+void RenderScene::UpdateMany(const std::vector<Change>& changes) {
+    // matrices first, in parallel: every proxy is written by exactly one entry
+    JobSystem::Get().ParallelFor(changes.size(), kRebuildGrain, [&](size_t begin, size_t end, int){
+        for (size_t i = begin; i < end; ++i) {
+            const Change& c = changes[i];
+            if (!(c.what & PartChange_Bounds) || !Find(c.part)) continue;
+            proxies[c.part->proxy.render].xform = BuildInstanceXform(c.part->GetCFrame(), c.part->GetSize());
+        }
+    });
+
+    // batch membership and slot copies touch shared vectors; keep them serial
+    for (const Change& c : changes) {
+        if (!Find(c.part)) continue;
+        const int32_t id = c.part->proxy.render;
+        Proxy& px = proxies[id];
+        if (c.what & (PartChange_Color | PartChange_Visibility)) {
+            Detach(id);
+            Attach(id);
+        } else if ((c.what & PartChange_Bounds) && px.batch >= 0) {
+            Batch& b = batches[px.batch];
+            b.xforms[px.slot] = px.xform;
+            MarkSlot(b, px.slot);
+        }
+    }
+}
+
+void RenderScene::Clear() {
+    proxies.clear();
+    freeProxies.clear();
+    for (auto& b : batches) {
+        b.xforms.clear();
+        b.owners.clear();
+        b.dirtySlots.clear();
+        b.slotDirty.clear();
+        b.visible.clear();
+    }
+}
+
+const float16& RenderScene::Xform(const BasePart* p) const {
+    return proxies[p->proxy.render].xform;
+}
+
+int32_t RenderScene::BatchOf(const BasePart* p) const {
+    const Proxy* px = Find(p);
+    return px ? px->batch : -1;
+}
+
+// ---------------- batches ----------------
+void RenderScene::Attach(int32_t id) {
+    Proxy& px = proxies[id];
+    if (!IsOpaque(px.part)) return;
+
+    const Color3 color = px.part->GetColor();
+    const Color c = { ToByte(color.r), ToByte(color.g), ToByte(color.b), 255 };
+    const uint32_t key = PackColor(c);
+    auto it = batchByColor.find(key);
+    if (it == batchByColor.end()) {
+        int32_t index;
+        if (!freeBatches.empty()) { index = freeBatches.back(); freeBatches.pop_back(); }
+        else { index = (int32_t)batches.size(); batches.emplace_back(); }
+        batches[index] = Batch{};
+        batches[index].color = c;
+        it = batchByColor.emplace(key, index).first;
+    }
+
+    Batch& b = batches[it->second];
+    b.emptyFrames = 0;
+    px.batch = it->second;
+    px.slot  = (int32_t)b.xforms.size();
+    b.xforms.push_back(px.xform);
+    b.owners.push_back(id);
+    b.slotDirty.push_back(0);
+    MarkSlot(b, px.slot);
+}
+
+void RenderScene::Detach(int32_t id) {
+    Proxy& px = proxies[id];
+    if (px.batch < 0) return;
+
+    Batch& b = batches[px.batch];
+    const int32_t last = (int32_t)b.xforms.size() - 1;
+    if (px.slot != last) {
+        // move the last slot into the hole
+        b.xforms[px.slot] = b.xforms[last];
+        b.owners[px.slot] = b.owners[last];
+        proxies[b.owners[px.slot]].slot = px.slot;
+        MarkSlot(b, px.slot);
+    }
+    b.xforms.pop_back();
+    b.owners.pop_back();
+    b.slotDirty.pop_back();
+
+    px.batch = -1;
+    px.slot  = -1;
+}
+
+void RenderScene::MarkSlot(Batch& b, int32_t slot) {
+    if (b.slotDirty[slot]) return;
+    b.slotDirty[slot] = 1;
+    b.dirtySlots.push_back(slot);
+}
+
+void RenderScene::FreeBatch(int32_t index) {
+    Batch& b = batches[index];
+    batchByColor.erase(PackColor(b.color));
+    if (b.vbo) rlUnloadVertexBuffer(b.vbo);
+    b = Batch{};   // also drops the CPU mirror's storage
+    b.inUse = false;
+    freeBatches.push_back(index);
+}
+
+// ---------------- GPU ----------------
+void RenderScene::Upload() {
+    for (auto& b : batches) {
+        const int count = (int)b.xforms.size();
+
+        if (count > b.capacity) {
+            // grow: new buffer, full upload
+            if (b.vbo) rlUnloadVertexBuffer(b.vbo);
+            b.capacity = std::max(64, count + count / 2);
+            b.vbo = rlLoadVertexBuffer(nullptr, b.capacity * (int)sizeof(float16), true);
+            rlUpdateVertexBuffer(b.vbo, b.xforms.data(), count * (int)sizeof(float16), 0);
+        } else if (!b.dirtySlots.empty()) {
+            if ((float)b.dirtySlots.size() > kFullUploadFraction * (float)count) {
+                rlUpdateVertexBuffer(b.vbo, b.xforms.data(), count * (int)sizeof(float16), 0);
+            } else {
+                // coalesce neighbouring slots into runs
+                std::sort(b.dirtySlots.begin(), b.dirtySlots.end());
+                size_t i = 0;
+                while (i < b.dirtySlots.size()) {
+                    const int32_t first = b.dirtySlots[i];
+                    int32_t last = first;
+                    while (i + 1 < b.dirtySlots.size() && b.dirtySlots[i + 1] == last + 1) last = b.dirtySlots[++i];
+                    ++i;
+                    if (first >= count) break;   // slots popped after being marked
+                    last = std::min(last, count - 1);
+                    rlUpdateVertexBuffer(b.vbo, &b.xforms[first], (last - first + 1) * (int)sizeof(float16),
+                                         first * (int)sizeof(float16));
+                }
+            }
+        }
+
+        for (int32_t s : b.dirtySlots) if (s < count) b.slotDirty[s] = 0;
+        b.dirtySlots.clear();
+    }
+
+    // stream buffers alternate frames so we never overwrite data the GPU may still read
+    const int k = streamFrame & 1;
+    const int n = (int)stream.size();
+    if (n == 0) return;
+    if (n > streamCapacity[k]) {
+        if (streamVbo[k]) rlUnloadVertexBuffer(streamVbo[k]);
+        if (streamTintVbo[k]) rlUnloadVertexBuffer(streamTintVbo[k]);
+        streamCapacity[k] = std::max(256, n + n / 2);
+        streamVbo[k] = rlLoadVertexBuffer(nullptr, streamCapacity[k] * (int)sizeof(float16), true);
+        streamTintVbo[k] = rlLoadVertexBuffer(nullptr, streamCapacity[k] * (int)sizeof(Color), true);
+    }
+    rlUpdateVertexBuffer(streamVbo[k], stream.data(), n * (int)sizeof(float16), 0);
+    rlUpdateVertexBuffer(streamTintVbo[k], streamTint.data(), n * (int)sizeof(Color), 0);
+}
+
+void RenderScene::EndFrame() {
+    stream.clear();
+    streamTint.clear();
+    for (int32_t i = 0; i < (int32_t)batches.size(); ++i) {
+        Batch& b = batches[i];
+        b.visible.clear();
+        if (!b.inUse || !b.xforms.empty()) continue;
+        // colors come and go (scripts cycling a part's color); keep a batch
+        // through one empty frame in case its color returns, then free it
+        if (++b.emptyFrames > kEmptyBatchFrames) FreeBatch(i);
+    }
+    streamFrame++;
+}
+
+void RenderScene::Release() {
+    for (auto& b : batches) {
+        if (b.vbo) rlUnloadVertexBuffer(b.vbo);
+        b.vbo = 0;
+        b.capacity = 0;
+        // force a full upload if the scene is drawn again
+        b.dirtySlots.clear();
+        std::fill(b.slotDirty.begin(), b.slotDirty.end(), 0);
+    }
+    for (int k = 0; k < 2; k++) {
+        if (streamVbo[k]) rlUnloadVertexBuffer(streamVbo[k]);
+        if (streamTintVbo[k]) rlUnloadVertexBuffer(streamTintVbo[k]);
+        streamVbo[k] = 0;
+        streamTintVbo[k] = 0;
+        streamCapacity[k] = 0;
+    }
+}
+
+// ---------------- drawing ----------------
+void DrawMeshInstancedBuffer(const Mesh& mesh, const Material& material,
+                             unsigned int vbo, int first, int count,
+                             unsigned int tintVbo)
+{
+    if (count <= 0 || !vbo) return;
+    const Shader& sh = material.shader;
+    rlEnableShader(sh.id);
+
+    if (sh.locs[SHADER_LOC_COLOR_DIFFUSE] != -1) {
+        const Color c = material.maps[MATERIAL_MAP_DIFFUSE].color;
+        const float values[4] = { c.r/255.0f, c.g/255.0f, c.b/255.0f, c.a/255.0f };
+        rlSetUniform(sh.locs[SHADER_LOC_COLOR_DIFFUSE], values, SHADER_UNIFORM_VEC4, 1);
+    }
+
+    // same matrix setup DrawMeshInstanced does (model comes from the instance attribute)
+    const Matrix matView = rlGetMatrixModelview();
+    const Matrix matProjection = rlGetMatrixProjection();
+    if (sh.locs[SHADER_LOC_MATRIX_VIEW] != -1) rlSetUniformMatrix(sh.locs[SHADER_LOC_MATRIX_VIEW], matView);
+    if (sh.locs[SHADER_LOC_MATRIX_PROJECTION] != -1) rlSetUniformMatrix(sh.locs[SHADER_LOC_MATRIX_PROJECTION], matProjection);
+    const Matrix matModelView = MatrixMultiply(rlGetMatrixTransform(), matView);
+    rlSetUniformMatrix(sh.locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(matModelView, matProjection));
+
+    rlEnableVertexArray(mesh.vaoId);
+    const int loc = sh.locs[SHADER_LOC_MATRIX_MODEL];
+    if (loc != -1) {
+        rlEnableVertexBuffer(vbo);
+        for (int i = 0; i < 4; i++) {
+            rlEnableVertexAttribute(loc + i);
+            rlSetVertexAttribute(loc + i, 4, RL_FLOAT, false, (int)sizeof(float16),
+                                 first * (int)sizeof(float16) + i * (int)sizeof(Vector4));
+            rlSetVertexAttributeDivisor(loc + i, 1);
+        }
+    }
+
+    const int tintLoc = sh.locs[SHADER_LOC_VERTEX_COLOR];
+    if (tintLoc != -1) {
+        if (tintVbo) {
+            rlEnableVertexBuffer(tintVbo);
+            rlEnableVertexAttribute(tintLoc);
+            rlSetVertexAttribute(tintLoc, 4, RL_UNSIGNED_BYTE, true, (int)sizeof(Color), first * (int)sizeof(Color));
+            rlSetVertexAttributeDivisor(tintLoc, 1);
+        } else {
+            // the VAO is shared, so a previous tinted draw may have left the array enabled
+            const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+            rlDisableVertexAttribute(tintLoc);
+            rlSetVertexAttributeDefault(tintLoc, white, SHADER_ATTRIB_VEC4, 4);
+        }
+    }
+
+    if (mesh.indices != nullptr) rlDrawVertexArrayElementsInstanced(0, mesh.triangleCount*3, 0, count);
+    else                         rlDrawVertexArrayInstanced(0, mesh.vertexCount, count);
+
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    rlDisableVertexBufferElement();
+    rlDisableShader();
+}
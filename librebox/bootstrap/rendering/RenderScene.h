@@ -0,0 +1,108 @@
+// ================== bootstrap/rendering/RenderScene.h ==================
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <raylib.h>
+#include <raymath.h>
+
+struct BasePart;
+
+// Retained render proxies for workspace parts. Every part keeps its instance
+// matrix cached between frames; opaque parts additionally own a slot in a
+// persistent per-color instance buffer that is only re-uploaded where slots
+// changed.
+class RenderScene {
+public:
+    struct Batch {
+        Color color{};
+        std::vector<float16> xforms;       // CPU mirror of 'vbo', column-major
+        std::vector<int32_t> owners;       // proxy index per slot
+        unsigned int vbo{0};
+        int capacity{0};                   // slots allocated in 'vbo'
+        std::vector<int32_t> dirtySlots;
+        std::vector<uint8_t> slotDirty;
+        bool inUse{true};                  // false once freed; the index is reused by a new color
+        int  emptyFrames{0};               // frames ended with no members
+
+        // per-frame: visible members gathered by the renderer
+        std::vector<const float16*> visible;
+    };
+
+    RenderScene() = default;
+    RenderScene(const RenderScene&) = delete;
+    RenderScene& operator=(const RenderScene&) = delete;
+
+    void Add(BasePart* p);
+    void Remove(BasePart* p);
+    // 'what' is a mask of PartChange bits
+    void Update(BasePart* p, uint32_t what);
+
+    struct Change { BasePart* part; uint32_t what; };
+    // Update() for a whole frame's worth of changes; matrix rebuilds run on the JobSystem
+    void UpdateMany(const std::vector<Change>& changes);
+
+    // Drops all proxies without touching the parts (they may already be gone)
+    void Clear();
+
+    // Cached instance matrix of a part added to this scene
+    const float16& Xform(const BasePart* p) const;
+    // Batch index of an opaque part, -1 otherwise
+    int32_t BatchOf(const BasePart* p) const;
+
+    std::vector<Batch>& Batches() { return batches; }
+
+    // Transient instances for this frame (culled subsets, sorted transparents); returns the index
+    int  PushStream(const float16& m, Color tint = WHITE) {
+        stream.push_back(m);
+        streamTint.push_back(tint);
+        return (int)stream.size() - 1;
+    }
+    int  StreamSize() const { return (int)stream.size(); }
+    unsigned int StreamBuffer() const { return streamVbo[streamFrame & 1]; }
+    // per-instance RGBA8 tint, indexed like StreamBuffer()
+    unsigned int StreamTintBuffer() const { return streamTintVbo[streamFrame & 1]; }
+
+    // Push dirty batch slots and this frame's stream to the GPU. Needs the GL context.
+    void Upload();
+    // Forget the stream after the frame has been drawn; frees batches (and their
+    // buffers) that have stayed empty for a whole frame. Needs the GL context.
+    void EndFrame();
+    // Free GPU buffers. Needs the GL context.
+    void Release();
+
+private:
+    struct Proxy {
+        BasePart* part{nullptr};
+        float16   xform{};
+        int32_t   batch{-1};
+        int32_t   slot{-1};
+    };
+
+    std::vector<Proxy>   proxies;
+    std::vector<int32_t> freeProxies;
+    std::vector<Batch>   batches;
+    std::vector<int32_t> freeBatches;
+    std::unordered_map<uint32_t, int32_t> batchByColor;
+
+    std::vector<float16> stream;
+    std::vector<Color>   streamTint;
+    unsigned int streamVbo[2]{0, 0};
+    unsigned int streamTintVbo[2]{0, 0};
+    int streamCapacity[2]{0, 0};
+    uint32_t streamFrame{0};
+
+    const Proxy* Find(const BasePart* p) const;
+    void Attach(int32_t id);   // place in the batch matching the part's color (if opaque)
+    void Detach(int32_t id);   // swap-remove from its batch
+    void MarkSlot(Batch& b, int32_t slot);
+    void FreeBatch(int32_t index);
+};
+
+// DrawMeshInstanced, but reading 'count' instance matrices starting at
+// 'first' from an existing VBO instead of uploading a temporary one.
+// 'tintVbo' (RGBA8, indexed like 'vbo') feeds SHADER_LOC_VERTEX_COLOR as a
+// per-instance attribute; without it that attribute reads as white.
+void DrawMeshInstancedBuffer(const Mesh& mesh, const Material& material,
+                             unsigned int vbo, int first, int count,
+                             unsigned int tintVbo = 0);
@@ -0,0 +1,304 @@
+// ================== bootstrap/rendering/SpatialIndex.cpp ==================
+#include "bootstrap/rendering/SpatialIndex.h"
+#include "core/datatypes/CFrame.h"
+#include <algorithm>
+#include <cmath>
+
+// Fattening applied to leaf boxes so parts that jitter in place stay put in the tree
+static constexpr float kFatMargin = 0.25f;
+
+// ---------------- helpers ----------------
+static inline AABB Union(const AABB& a, const AABB& b) {
+    return {
+        { std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+        { std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) }
+    };
+}
+
+// surface-area heuristic cost
+static inline float Area(const AABB& b) {
+    const float dx = b.max.x - b.min.x, dy = b.max.y - b.min.y, dz = b.max.z - b.min.z;
+    return 2.0f * (dx*dy + dy*dz + dz*dx);
+}
+
+static inline AABB Fatten(const AABB& b) {
+    return {
+        { b.min.x - kFatMargin, b.min.y - kFatMargin, b.min.z - kFatMargin },
+        { b.max.x + kFatMargin, b.max.y + kFatMargin, b.max.z + kFatMargin }
+    };
+}
+
+AABB ComputeBoxBounds(const CFrame& cf, ::Vector3 size) {
+    // half extents of the oriented box projected on each world axis (R is row-major)
+    const float hx = 0.5f * size.x, hy = 0.5f * size.y, hz = 0.5f * size.z;
+    const float ex = std::fabs(cf.R[0])*hx + std::fabs(cf.R[1])*hy + std::fabs(cf.R[2])*hz;
+    const float ey = std::fabs(cf.R[3])*hx + std::fabs(cf.R[4])*hy + std::fabs(cf.R[5])*hz;
+    const float ez = std::fabs(cf.R[6])*hx + std::fabs(cf.R[7])*hy + std::fabs(cf.R[8])*hz;
+    return {
+        { cf.p.x - ex, cf.p.y - ey, cf.p.z - ez },
+        { cf.p.x + ex, cf.p.y + ey, cf.p.z + ez }
+    };
+}
+
+// ---------------- frustum ----------------
+static inline Vector4 NormalizePlane(Vector4 p) {
+    const float len = std::sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
+    if (len > 0.0f) { p.x /= len; p.y /= len; p.z /= len; p.w /= len; }
+    return p;
+}
+
+Frustum Frustum::FromViewProjection(const Matrix& m) {
+    // raylib matrices are column-major: clip = M * p, rows are (m0,m4,m8,m12), ...
+    const Vector4 r0 = { m.m0, m.m4, m.m8,  m.m12 };
+    const Vector4 r1 = { m.m1, m.m5, m.m9,  m.m13 };
+    const Vector4 r2 = { m.m2, m.m6, m.m10, m.m14 };
+    const Vector4 r3 = { m.m3, m.m7, m.m11, m.m15 };
+
+    auto add = [](Vector4 a, Vector4 b){ return Vector4{ a.x+b.x, a.y+b.y, a.z+b.z, a.w+b.w }; };
+    auto sub = [](Vector4 a, Vector4 b){ return Vector4{ a.x-b.x, a.y-b.y, a.z-b.z, a.w-b.w }; };
+
+    Frustum f;
+    f.planes[Left]   = NormalizePlane(add(r3, r0));
+    f.planes[Right]  = NormalizePlane(sub(r3, r0));
+    f.planes[Bottom] = NormalizePlane(add(r3, r1));
+    f.planes[Top]    = NormalizePlane(sub(r3, r1));
+    f.planes[Near]   = NormalizePlane(add(r3, r2));
+    f.planes[Far]    = NormalizePlane(sub(r3, r2));
+    return f;
+}
+
+// ---------------- parallel queries ----------------
+void SpatialIndex::SplitQuery(const Frustum& fr, size_t maxPieces, std::vector<SubQuery>& out) const {
+    if (root == kNull) return;
+
+    // breadth-first expansion; pieces are re-tested by QueryFrom, so only the
+    // expanded nodes need culling here
+    std::vector<SubQuery> frontier{ { root, (1u << Frustum::Count) - 1u } };
+    std::vector<SubQuery> next;
+    while (frontier.size() < maxPieces) {
+        next.clear();
+        bool expanded = false;
+        for (size_t k = 0; k < frontier.size(); ++k) {
+            const SubQuery q = frontier[k];
+            const Node& n = nodes[q.node];
+            // pieces if this node were split: what is queued + its two children + the rest
+            const size_t pieces = next.size() + 2 + (frontier.size() - k - 1);
+            if (n.IsLeaf() || pieces > maxPieces) { next.push_back(q); continue; }
+
+            uint32_t mask = q.mask;
+            bool outside = false;
+            for (int i = 0; i < Frustum::Count && mask; ++i) {
+                if (!(mask & (1u << i))) continue;
+                const int c = ClassifyBox(n.box, fr.planes[i]);
+                if (c < 0) { outside = true; break; }
+                if (c > 0) mask &= ~(1u << i);
+            }
+            expanded = true;
+            if (outside) continue;
+            next.push_back({ n.child1, mask });
+            next.push_back({ n.child2, mask });
+        }
+        frontier.swap(next);
+        if (!expanded) break;
+    }
+    out.insert(out.end(), frontier.begin(), frontier.end());
+}
+
+// ---------------- tree ----------------
+SpatialIndex::SpatialIndex() {
+    nodes.reserve(1024);
+}
+
+void SpatialIndex::Clear() {
+    nodes.clear();
+    root = kNull;
+    freeList = kNull;
+    leafCount = 0;
+}
+
+int32_t SpatialIndex::AllocNode() {
+    if (freeList == kNull) {
+        nodes.emplace_back();
+        return (int32_t)nodes.size() - 1;
+    }
+    const int32_t id = freeList;
+    freeList = nodes[id].parent;
+    nodes[id] = Node{};
+    return id;
+}
+
+void SpatialIndex::FreeNode(int32_t id) {
+    nodes[id].parent   = freeList;
+    nodes[id].height   = -1;
+    nodes[id].userData = nullptr;
+    freeList = id;
+}
+
+int32_t SpatialIndex::Insert(const AABB& box, void* userData) {
+    const int32_t id = AllocNode();
+    nodes[id].box      = Fatten(box);
+    nodes[id].userData = userData;
+    nodes[id].height   = 0;
+    InsertLeaf(id);
+    leafCount++;
+    return id;
+}
+
+void SpatialIndex::Remove(int32_t proxy) {
+    if (proxy < 0 || proxy >= (int32_t)nodes.size() || nodes[proxy].height != 0) return;
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    leafCount--;
+}
+
+bool SpatialIndex::Move(int32_t proxy, const AABB& box) {
+    if (proxy < 0 || proxy >= (int32_t)nodes.size() || nodes[proxy].height != 0) return false;
+
+    const AABB& fat = nodes[proxy].box;
+    if (fat.Contains(box)) {
+        // still fits; only re-insert if the part shrank well inside its fat box
+        const AABB big = { { box.min.x - 4.0f*kFatMargin, box.min.y - 4.0f*kFatMargin, box.min.z - 4.0f*kFatMargin },
+                           { box.max.x + 4.0f*kFatMargin, box.max.y + 4.0f*kFatMargin, box.max.z + 4.0f*kFatMargin } };
+        if (big.Contains(fat)) return false;
+    }
+
+    RemoveLeaf(proxy);
+    nodes[proxy].box = Fatten(box);
+    InsertLeaf(proxy);
+    return true;
+}
+
+void SpatialIndex::InsertLeaf(int32_t leaf) {
+    if (root == kNull) {
+        root = leaf;
+        nodes[root].parent = kNull;
+        return;
+    }
+
+    // find the best sibling by descending with the SAH cost
+    const AABB leafBox = nodes[leaf].box;
+    int32_t idx = root;
+    while (!nodes[idx].IsLeaf()) {
+        const int32_t c1 = nodes[idx].child1;
+        const int32_t c2 = nodes[idx].child2;
+
+        const float area = Area(nodes[idx].box);
+        const float combinedArea = Area(Union(nodes[idx].box, leafBox));
+
+        // cost of making a new parent for this node and the new leaf
+        const float cost = 2.0f * combinedArea;
+        // minimum cost of pushing the leaf further down the tree
+        const float inheritance = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](int32_t c){
+            const AABB u = Union(leafBox, nodes[c].box);
+            if (nodes[c].IsLeaf()) return Area(u) + inheritance;
+            return (Area(u) - Area(nodes[c].box)) + inheritance;
+        };
+        const float cost1 = childCost(c1);
+        const float cost2 = childCost(c2);
+
+        if (cost < cost1 && cost < cost2) break;
+        idx = (cost1 < cost2) ? c1 : c2;
+    }
+    const int32_t sibling = idx;
+
+    // new parent
+    const int32_t oldParent = nodes[sibling].parent;
+    const int32_t newParent = AllocNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box    = Union(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent    = newParent;
+
+    if (oldParent != kNull) {
+        if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+        else                                    nodes[oldParent].child2 = newParent;
+    } else {
+        root = newParent;
+    }
+
+    // walk back up fixing heights and boxes
+    for (idx = nodes[leaf].parent; idx != kNull; idx = nodes[idx].parent) {
+        idx = Balance(idx);
+        const int32_t c1 = nodes[idx].child1, c2 = nodes[idx].child2;
+        nodes[idx].height = 1 + std::max(nodes[c1].height, nodes[c2].height);
+        nodes[idx].box    = Union(nodes[c1].box, nodes[c2].box);
+    }
+}
+
+void SpatialIndex::RemoveLeaf(int32_t leaf) {
+    if (leaf == root) { root = kNull; return; }
+
+    const int32_t parent      = nodes[leaf].parent;
+    const int32_t grandParent = nodes[parent].parent;
+    const int32_t sibling     = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent != kNull) {
+        if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+        else                                     nodes[grandParent].child2 = sibling;
+        nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        for (int32_t idx = grandParent; idx != kNull; idx = nodes[idx].parent) {
+            idx = Balance(idx);
+            const int32_t c1 = nodes[idx].child1, c2 = nodes[idx].child2;
+            nodes[idx].box    = Union(nodes[c1].box, nodes[c2].box);
+            nodes[idx].height = 1 + std::max(nodes[c1].height, nodes[c2].height);
+        }
+    } else {
+        root = sibling;
+        nodes[sibling].parent = kNull;
+        FreeNode(parent);
+    }
+}
+
+// AVL-style rotation; returns the index now occupying a's position
+int32_t SpatialIndex::Balance(int32_t iA) {
+    Node& A = nodes[iA];
+    if (A.IsLeaf() || A.height < 2) return iA;
+
+    const int32_t iB = A.child1;
+    const int32_t iC = A.child2;
+    const int32_t balance = nodes[iC].height - nodes[iB].height;
+
+    auto rotate = [&](int32_t iUp, int32_t iOther, bool upIsChild2) -> int32_t {
+        // promote iUp above iA
+        Node& U = nodes[iUp];
+        const int32_t iF = U.child1;
+        const int32_t iG = U.child2;
+
+        U.child1 = iA;
+        U.parent = nodes[iA].parent;
+        nodes[iA].parent = iUp;
+
+        if (U.parent != kNull) {
+            if (nodes[U.parent].child1 == iA) nodes[U.parent].child1 = iUp;
+            else                              nodes[U.parent].child2 = iUp;
+        } else {
+            root = iUp;
+        }
+
+        // keep the taller grandchild under U, hand the shorter one to A
+        const bool fTaller = nodes[iF].height > nodes[iG].height;
+        const int32_t keep = fTaller ? iF : iG;
+        const int32_t give = fTaller ? iG : iF;
+
+        U.child2 = keep;
+        if (upIsChild2) nodes[iA].child2 = give; else nodes[iA].child1 = give;
+        nodes[give].parent = iA;
+
+        nodes[iA].box    = Union(nodes[iOther].box, nodes[give].box);
+        nodes[iA].height = 1 + std::max(nodes[iOther].height, nodes[give].height);
+        U.box    = Union(nodes[iA].box, nodes[keep].box);
+        U.height = 1 + std::max(nodes[iA].height, nodes[keep].height);
+        return iUp;
+    };
+
+    if (balance > 1)  return rotate(iC, iB, /*upIsChild2*/true);
+    if (balance < -1) return rotate(iB, iC, /*upIsChild2*/false);
+    return iA;
+}
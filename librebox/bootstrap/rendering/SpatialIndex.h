@@ -0,0 +1,170 @@
+// ================== bootstrap/rendering/SpatialIndex.h ==================
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <raylib.h>
+
+struct CFrame;
+
+// Axis-aligned box in world space
+struct AABB {
+    ::Vector3 min{0.0f, 0.0f, 0.0f};
+    ::Vector3 max{0.0f, 0.0f, 0.0f};
+
+    bool Contains(const AABB& o) const {
+        return min.x <= o.min.x && min.y <= o.min.y && min.z <= o.min.z
+            && max.x >= o.max.x && max.y >= o.max.y && max.z >= o.max.z;
+    }
+    bool Overlaps(const AABB& o) const {
+        return min.x <= o.max.x && max.x >= o.min.x
+            && min.y <= o.max.y && max.y >= o.min.y
+            && min.z <= o.max.z && max.z >= o.min.z;
+    }
+};
+
+// World bounds of a box of 'size' placed at 'cf' (oriented box -> AABB)
+AABB ComputeBoxBounds(const CFrame& cf, ::Vector3 size);
+
+// Six clip planes (a,b,c,d), inside when a*x + b*y + c*z + d >= 0
+struct Frustum {
+    enum { Left, Right, Bottom, Top, Near, Far, Count };
+    Vector4 planes[Count];
+
+    // Gribb/Hartmann extraction from a raylib view*projection matrix (MatrixMultiply(view, proj))
+    static Frustum FromViewProjection(const Matrix& vp);
+
+    // Conservative: false only when the box is fully outside one plane
+    bool Overlaps(const AABB& b) const;
+};
+
+// Dynamic AABB tree (incremental BVH). Leaves store a fattened box so small
+// moves do not touch the tree; larger moves re-insert the leaf.
+class SpatialIndex {
+public:
+    static constexpr int32_t kNull = -1;
+
+    SpatialIndex();
+
+    int32_t Insert(const AABB& box, void* userData);
+    void    Remove(int32_t proxy);
+    // Returns true if the leaf had to be re-inserted
+    bool    Move(int32_t proxy, const AABB& box);
+    void    Clear();
+
+    void*       GetUserData(int32_t proxy) const { return nodes[proxy].userData; }
+    const AABB& GetFatAABB(int32_t proxy) const  { return nodes[proxy].box; }
+    int32_t     Count() const { return leafCount; }
+    int32_t     Height() const { return root == kNull ? 0 : nodes[root].height; }
+
+    // visit(void* userData) for every leaf whose fat box touches the frustum
+    template<class F> void Query(const Frustum& fr, F&& visit) const;
+
+    // A frustum query can be split into independent subtree queries and run in parallel:
+    // SplitQuery appends up to ~maxPieces pieces, QueryFrom runs one of them.
+    struct SubQuery { int32_t node; uint32_t mask; };
+    void SplitQuery(const Frustum& fr, size_t maxPieces, std::vector<SubQuery>& out) const;
+    template<class F> void QueryFrom(const Frustum& fr, SubQuery from, F&& visit) const;
+    // visit(void* userData) for every leaf whose fat box overlaps 'box'
+    template<class F> void Query(const AABB& box, F&& visit) const;
+
+private:
+    struct Node {
+        AABB    box;
+        void*   userData{nullptr};
+        int32_t parent{kNull};   // doubles as free-list link
+        int32_t child1{kNull};
+        int32_t child2{kNull};
+        int32_t height{-1};      // -1 free, 0 leaf
+        bool IsLeaf() const { return child1 == kNull; }
+    };
+
+    std::vector<Node> nodes;
+    int32_t root{kNull};
+    int32_t freeList{kNull};
+    int32_t leafCount{0};
+
+    int32_t AllocNode();
+    void    FreeNode(int32_t id);
+    void    InsertLeaf(int32_t leaf);
+    void    RemoveLeaf(int32_t leaf);
+    int32_t Balance(int32_t a);
+
+    // plane classification: -1 outside, 0 intersecting, 1 fully inside
+    static int ClassifyBox(const AABB& b, const Vector4& p);
+};
+
+// ---------------- queries ----------------
+inline bool Frustum::Overlaps(const AABB& b) const {
+    for (const Vector4& p : planes) {
+        const float px = p.x >= 0.0f ? b.max.x : b.min.x;
+        const float py = p.y >= 0.0f ? b.max.y : b.min.y;
+        const float pz = p.z >= 0.0f ? b.max.z : b.min.z;
+        if (p.x*px + p.y*py + p.z*pz + p.w < 0.0f) return false;
+    }
+    return true;
+}
+
+inline int SpatialIndex::ClassifyBox(const AABB& b, const Vector4& p) {
+    // positive vertex (furthest along the normal) and negative vertex
+    const float px = p.x >= 0.0f ? b.max.x : b.min.x;
+    const float py = p.y >= 0.0f ? b.max.y : b.min.y;
+    const float pz = p.z >= 0.0f ? b.max.z : b.min.z;
+    if (p.x*px + p.y*py + p.z*pz + p.w < 0.0f) return -1;
+    const float nx = p.x >= 0.0f ? b.min.x : b.max.x;
+    const float ny = p.y >= 0.0f ? b.min.y : b.max.y;
+    const float nz = p.z >= 0.0f ? b.min.z : b.max.z;
+    return (p.x*nx + p.y*ny + p.z*nz + p.w >= 0.0f) ? 1 : 0;
+}
+
+template<class F>
+void SpatialIndex::Query(const Frustum& fr, F&& visit) const {
+    if (root == kNull) return;
+    QueryFrom(fr, SubQuery{ root, (1u << Frustum::Count) - 1u }, visit);
+}
+
+template<class F>
+void SpatialIndex::QueryFrom(const Frustum& fr, SubQuery from, F&& visit) const {
+    if (from.node == kNull) return;
+
+    // (node, mask of planes still to test); reused per thread so queries do not allocate
+    thread_local std::vector<SubQuery> stack;
+    stack.clear();
+    stack.push_back(from);
+
+    while (!stack.empty()) {
+        const SubQuery it = stack.back(); stack.pop_back();
+        const Node& n = nodes[it.node];
+
+        uint32_t mask = it.mask;
+        bool outside = false;
+        for (int i = 0; i < Frustum::Count && mask; ++i) {
+            if (!(mask & (1u << i))) continue;
+            const int c = ClassifyBox(n.box, fr.planes[i]);
+            if (c < 0) { outside = true; break; }
+            if (c > 0) mask &= ~(1u << i); // children are inside this plane too
+        }
+        if (outside) continue;
+
+        if (n.IsLeaf()) { visit(n.userData); continue; }
+        stack.push_back({ n.child1, mask });
+        stack.push_back({ n.child2, mask });
+    }
+}
+
+template<class F>
+void SpatialIndex::Query(const AABB& box, F&& visit) const {
+    if (root == kNull) return;
+
+    thread_local std::vector<int32_t> stack;
+    stack.clear();
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+        const Node& n = nodes[stack.back()]; stack.pop_back();
+        if (!n.box.Overlaps(box)) continue;
+        if (n.IsLeaf()) { visit(n.userData); continue; }
+        stack.push_back(n.child1);
+        stack.push_back(n.child2);
+    }
+}
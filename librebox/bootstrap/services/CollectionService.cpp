@@ -0,0 +1,94 @@
+#include "bootstrap/services/CollectionService.h"
+#include "bootstrap/Game.h"
+#include "bootstrap/LuaAtoms.h"
+#include "bootstrap/ScriptingAPI.h"
+#include "lua.h"
+#include "lualib.h"
+
+CollectionService::CollectionService() : Service("CollectionService", InstanceClass::CollectionService) {
+    Instance::SetTagListener([this](const std::shared_ptr<Instance>& inst, const std::string& tag, bool added) {
+        OnTag(inst, tag, added);
+    });
+}
+
+CollectionService::~CollectionService() {
+    Instance::SetTagListener(nullptr);
+}
+
+static std::shared_ptr<RTScriptSignal> SignalFor(std::unordered_map<std::string, std::shared_ptr<RTScriptSignal>>& signals,
+                                                 const std::string& tag) {
+    auto& sig = signals[tag];
+    if (!sig) sig = std::make_shared<RTScriptSignal>((g_game && g_game->luaScheduler) ? g_game->luaScheduler.get() : nullptr);
+    return sig;
+}
+
+std::shared_ptr<RTScriptSignal> CollectionService::InstanceAddedSignal(const std::string& tag) {
+    return SignalFor(addedSignals, tag);
+}
+
+std::shared_ptr<RTScriptSignal> CollectionService::InstanceRemovedSignal(const std::string& tag) {
+    return SignalFor(removedSignals, tag);
+}
+
+// Fired from the main state, like the RunService events
+void CollectionService::OnTag(const std::shared_ptr<Instance>& inst, const std::string& tag, bool added) {
+    auto& signals = added ? addedSignals : removedSignals;
+    auto it = signals.find(tag);
+    if (it == signals.end()) return;
+    lua_State* L = (g_game && g_game->luaScheduler) ? g_game->luaScheduler->GetMainState() : nullptr;
+    if (!L) return;
+
+    auto sig = it->second;   // a listener may ask for new signals
+    lua_checkstack(L, 1);
+    Lua_PushInstance(L, inst);
+    sig->Fire(L, lua_gettop(L), 1);
+    lua_pop(L, 1);
+}
+
+// CollectionService:GetTagged(tag)
+static int l_cs_gettagged(lua_State* L) {
+    Lua_CheckInstance(L, 1);
+    const char* tag = luaL_checkstring(L, 2);
+    auto tagged = Instance::GetTagged(tag);
+    lua_createtable(L, (int)tagged.size(), 0);
+    int i = 1;
+    for (auto& inst : tagged) { Lua_PushInstance(L, inst); lua_rawseti(L, -2, i++); }
+    return 1;
+}
+
+static CollectionService* check_cs(lua_State* L) {
+    auto* inst = Lua_CheckInstance(L, 1);
+    if (!*inst || (*inst)->Class != InstanceClass::CollectionService) luaL_error(L, "expected CollectionService");
+    return static_cast<CollectionService*>(inst->get());
+}
+
+// CollectionService:GetInstanceAddedSignal(tag); may create the signal, so serial only
+static int l_cs_addedsignal(lua_State* L) {
+    auto* cs = check_cs(L);
+    Lua_CheckSerial(L, "GetInstanceAddedSignal");
+    Lua_PushSignal(L, cs->InstanceAddedSignal(luaL_checkstring(L, 2)));
+    return 1;
+}
+
+// CollectionService:GetInstanceRemovedSignal(tag); may create the signal, so serial only
+static int l_cs_removedsignal(lua_State* L) {
+    auto* cs = check_cs(L);
+    Lua_CheckSerial(L, "GetInstanceRemovedSignal");
+    Lua_PushSignal(L, cs->InstanceRemovedSignal(luaL_checkstring(L, 2)));
+    return 1;
+}
+
+// AddTag/RemoveTag/HasTag/GetTags are the Instance methods, which also take
+// the CollectionService:AddTag(inst, tag) form
+bool CollectionService::LuaGet(lua_State* L, int atom) const {
+    switch (atom) {
+    case Atom_GetTagged:                lua_pushcfunction(L, l_cs_gettagged,     "GetTagged"); return true;
+    case Atom_GetInstanceAddedSignal:   lua_pushcfunction(L, l_cs_addedsignal,   "GetInstanceAddedSignal"); return true;
+    case Atom_GetInstanceRemovedSignal: lua_pushcfunction(L, l_cs_removedsignal, "GetInstanceRemovedSignal"); return true;
+    default: return Instance::LuaGet(L, atom);
+    }
+}
+
+static Instance::Registrar s_regCollectionService("CollectionService", []{
+    return Instance::Make<CollectionService>();
+});
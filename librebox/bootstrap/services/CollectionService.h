@@ -0,0 +1,25 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "bootstrap/services/Service.h"
+#include "bootstrap/signals/Signal.h"
+struct lua_State;
+
+// Tag queries over the DataModel. Tags live on the instances (Instance::AddTag)
+// and membership comes from Instance's tag index, so GetTagged never walks the
+// tree. Added/removed signals are created per tag on first request.
+struct CollectionService : Service {
+    CollectionService();
+    ~CollectionService() override;
+
+    std::shared_ptr<RTScriptSignal> InstanceAddedSignal(const std::string& tag);
+    std::shared_ptr<RTScriptSignal> InstanceRemovedSignal(const std::string& tag);
+
+    bool LuaGet(lua_State* L, int atom) const override;
+
+private:
+    void OnTag(const std::shared_ptr<Instance>& inst, const std::string& tag, bool added);
+
+    std::unordered_map<std::string, std::shared_ptr<RTScriptSignal>> addedSignals, removedSignals;
+};
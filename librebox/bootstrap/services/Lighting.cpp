@@ -3,31 +3,19 @@
 #include "core/datatypes/Color3.h"
 #include "lua.h"
 #include "lualib.h"
-#include <cstring>
+#include "bootstrap/LuaAtoms.h"
+#include "bootstrap/Reflection.h"
 
 // Register with the service factory
 static Instance::Registrar s_regLighting("Lighting", [] {
-    return std::make_shared<Lighting>();
+    return Instance::Make<Lighting>();
 });
 
-bool Lighting::LuaGet(lua_State* L, const char* k) const {
-    if (!strcmp(k,"ClockTime")) { lua_pushnumber(L, (double)ClockTime); return true; }
-    if (!strcmp(k,"Brightness")) { lua_pushnumber(L, (double)Brightness); return true; }
-    if (!strcmp(k,"Ambient")) { 
-        lb::push(L, Color3{ Ambient.r, Ambient.g, Ambient.b });
-        return true;
-    }
-    // add Ambient, ClockTime, etc.
-    return false;
-}
-bool Lighting::LuaSet(lua_State* L, const char* k, int idx) {
-    if (!strcmp(k,"Brightness")) { Brightness = (float)luaL_checknumber(L, idx); return true; }
-    if (!strcmp(k,"ClockTime")) { ClockTime = (float)luaL_checknumber(L, idx); return true; }
-    if (!strcmp(k,"Ambient")) {
-        const auto* c = lb::check<Color3>(L, idx);
-        Ambient = { c->r, c->g, c->b };
-        return true;
-    }
-    // add others
-    return false;
-}
\ No newline at end of file
+static constexpr PropertyInfo kLightingProps[] = {
+    Property<&Lighting::ClockTime>(Atom_ClockTime),
+    Property<&Lighting::Brightness>(Atom_Brightness),
+    Property<&Lighting::Ambient>(Atom_Ambient),
+};
+static constexpr PropertyTable kLightingTable(kLightingProps);
+
+const PropertyTable* Lighting::Properties() const { return &kLightingTable; }
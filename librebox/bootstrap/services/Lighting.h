@@ -12,6 +12,5 @@ struct Lighting : Service {
     explicit Lighting(std::string name = "Lighting")
         : Service(std::move(name), InstanceClass::Lighting) {}
 
-    bool LuaGet(lua_State* L, const char* key) const override;
-    bool LuaSet(lua_State* L, const char* key, int valueIndex) override;
+    const PropertyTable* Properties() const override;
 };
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "bootstrap/services/RunService.h"
-#include <cstring>
 #include "bootstrap/Game.h"
+#include "bootstrap/LuaAtoms.h"
 #include "core/logging/Logging.h"
 #include "bootstrap/Instance.h"
 
@@ -18,18 +18,20 @@ void RunService::EnsureSignals() const {
     if (!self->Heartbeat)      self->Heartbeat      = std::make_shared<RTScriptSignal>(sch);
 }
 
-bool RunService::LuaGet(lua_State* L, const char* key) const {
+bool RunService::LuaGet(lua_State* L, int atom) const {
     EnsureSignals();
-    if (std::strcmp(key, "PreRender")      == 0) { Lua_PushSignal(L, PreRender);      return true; }
-    if (std::strcmp(key, "PreAnimation")   == 0) { Lua_PushSignal(L, PreAnimation);   return true; }
-    if (std::strcmp(key, "PreSimulation")  == 0) { Lua_PushSignal(L, PreSimulation);  return true; }
-    if (std::strcmp(key, "PostSimulation") == 0) { Lua_PushSignal(L, PostSimulation); return true; }
-    if (std::strcmp(key, "Heartbeat")      == 0) { Lua_PushSignal(L, Heartbeat);      return true; }
-    if (std::strcmp(key, "RenderStepped")  == 0) { Lua_PushSignal(L, PreRender);      return true; }
-    if (std::strcmp(key, "Stepped")        == 0) { Lua_PushSignal(L, PreSimulation);  return true; }
-    return false;
+    switch (atom) {
+    case Atom_PreRender:      Lua_PushSignal(L, PreRender);      return true;
+    case Atom_PreAnimation:   Lua_PushSignal(L, PreAnimation);   return true;
+    case Atom_PreSimulation:  Lua_PushSignal(L, PreSimulation);  return true;
+    case Atom_PostSimulation: Lua_PushSignal(L, PostSimulation); return true;
+    case Atom_Heartbeat:      Lua_PushSignal(L, Heartbeat);      return true;
+    case Atom_RenderStepped:  Lua_PushSignal(L, PreRender);      return true;
+    case Atom_Stepped:        Lua_PushSignal(L, PreSimulation);  return true;
+    default: return Instance::LuaGet(L, atom);
+    }
 }
 
 static Instance::Registrar s_regRunService("RunService", []{
-    return std::make_shared<RunService>();
+    return Instance::Make<RunService>();
 });
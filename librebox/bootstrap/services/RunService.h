@@ -13,5 +13,5 @@ struct RunService : Service {
 
     RunService();
     void EnsureSignals() const;
-    bool LuaGet(lua_State* L, const char* key) const override;
+    bool LuaGet(lua_State* L, int atom) const override;
 };
\ No newline at end of file
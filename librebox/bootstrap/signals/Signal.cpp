@@ -1,5 +1,12 @@
 // ========= core/signals/Signal.cpp =========
 #include "Signal.h"
+#include "bootstrap/ScriptingAPI.h"   // Lua_PushCopy
+
+static SignalBehavior gBehavior = SignalBehavior::Deferred;
+static int            gImmediateDepth = 0;   // Fire() calls on the stack running listeners
+
+void RTScriptSignal::SetBehavior(SignalBehavior b) { gBehavior = b; }
+SignalBehavior RTScriptSignal::Behavior() { return gBehavior; }
 
 RTScriptSignal::RTScriptSignal(LuaScheduler* s) : sched(s) {
     Lm = s ? s->GetMainState() : nullptr;
@@ -17,10 +24,12 @@ size_t RTScriptSignal::Connect(lua_State* L, bool once, bool parallel){
     if (closed || !Lm) return 0;
     luaL_checktype(L, 1, LUA_TFUNCTION);
 
-    // move callback to main, take a registry ref (Luau API)
-    lua_pushvalue(L, 1);
-    lua_xmove(L, Lm, 1);
-    int ref = lua_ref(Lm, -1); // pops the value
+    // Listeners from an Actor's script belong to that actor's VM
+    LuaScheduler* owner = LuaScheduler::From(L);
+    if (!owner) return 0;
+
+    // registry ref (Luau API); the registry is shared by every thread of the VM
+    int ref = lua_ref(L, 1);
 
     Listener li;
     li.id = nextId++;
@@ -28,14 +37,8 @@ size_t RTScriptSignal::Connect(lua_State* L, bool once, bool parallel){
     li.once = once;
     li.parallel = parallel;
     li.connected = true;
-
-    if (!li.parallel) {
-        // Prepare a reusable coroutine for sequential callbacks
-        lua_newthread(Lm);
-        li.co = lua_tothread(Lm, -1);
-        luaL_sandboxthread(li.co);
-        li.threadRef = lua_ref(Lm, -1); // pops the thread
-    }
+    li.owner = owner;
+    if (owner != sched) li.ownerAlive = owner->Lifetime();
 
     const size_t idx = listeners.size();
     listeners.push_back(li);
@@ -61,140 +64,165 @@ void RTScriptSignal::Disconnect(size_t id){
     const size_t idx = it->second;
     Listener& li = listeners[idx];
 
-    if (li.connected) {
+    // a fired once-listener still waiting in a dispatch queue is cancelled too
+    if (li.connected || li.queued) {
         li.connected = false;
-        if (Lm && li.funcRef != LUA_NOREF) {
-            lua_unref(Lm, li.funcRef);
-            li.funcRef = LUA_NOREF;
-        }
-        if (Lm && li.threadRef != LUA_NOREF) {
-            lua_unref(Lm, li.threadRef);
-            li.threadRef = LUA_NOREF;
-            li.co = nullptr;
-        }
-        // O(1) remove from active list
-        const size_t pos = li.activePos;
-        if (pos != Listener::npos && pos < activeIdx.size()) {
-            const size_t lastIdx = activeIdx.back();
-            activeIdx[pos] = lastIdx;
-            listeners[lastIdx].activePos = pos;
-            activeIdx.pop_back();
-            li.activePos = Listener::npos;
-        }
+        li.queued = false;
+        lua_State* vm = live(li.owner, li.ownerAlive) ? li.owner->GetMainState() : nullptr;
+        if (vm && li.funcRef != LUA_NOREF) lua_unref(vm, li.funcRef);
+        li.funcRef = LUA_NOREF;
+        deactivate(li);
     }
 
     id2idx.erase(it);
 }
 
+void RTScriptSignal::deactivate(Listener& li){
+    const size_t pos = li.activePos;
+    if (pos != Listener::npos && pos < activeIdx.size()) {
+        const size_t lastIdx = activeIdx.back();
+        activeIdx[pos] = lastIdx;
+        listeners[lastIdx].activePos = pos;
+        activeIdx.pop_back();
+        li.activePos = Listener::npos;
+    }
+}
+
+bool RTScriptSignal::PushCallback(lua_State* co, uint32_t listener, size_t id){
+    if (listener >= listeners.size()) return false;
+    Listener& li = listeners[listener];
+    if (li.id != id || li.funcRef == LUA_NOREF) return false;
+    if (!li.connected && !li.queued) return false;
+
+    lua_getref(co, li.funcRef);
+    if (li.queued) {
+        // last call of a once-listener: the function goes with it
+        lua_unref(co, li.funcRef);
+        li.funcRef = LUA_NOREF;
+        li.queued  = false;
+        id2idx.erase(li.id);
+    }
+    return true;
+}
+
 int RTScriptSignal::Wait(lua_State* L){
     if (closed) return lua_yield(L, 0);
 
-    if (!sched) {
+    LuaScheduler* owner = LuaScheduler::From(L);
+    if (!owner) {
         luaL_error(L, "No scheduler");
         return 0;
     }
 
+    Waiter w;
     if (auto* self = static_cast<BaseScript*>(lua_getthreaddata(L))) {
-        sched->SetWaitEvent(self);
-        waiters.push_back(Waiter{Waiter::Kind::Script, self, nullptr});
+        w.kind   = Waiter::Kind::Script;
+        w.handle = owner->SetWaitEvent(self);
     } else {
-        sched->SetTaskWaitEvent(L);
-        waiters.push_back(Waiter{Waiter::Kind::Task, nullptr, L});
+        w.kind   = Waiter::Kind::Task;
+        w.handle = owner->SetTaskWaitEvent(L);
     }
+    w.owner = owner;
+    if (owner != sched) w.ownerAlive = owner->Lifetime();
+    waiters.push_back(std::move(w));
     return lua_yield(L, 0);
 }
 
+void RTScriptSignal::pushArgs(lua_State* co, lua_State* src, bool sameVM, int firstArgIdx, int argc){
+    for (int i = 0; i < argc; ++i) {
+        if (sameVM) {
+            lua_pushvalue(src, firstArgIdx + i);
+            lua_xmove(src, co, 1);
+        } else {
+            Lua_PushCopy(co, src, firstArgIdx + i);
+        }
+    }
+}
+
 void RTScriptSignal::wakeWaitersWithArgsOnNextFrame(lua_State* src, int firstArgIdx, int argc){
     if (!sched || !Lm) return;
 
     auto ws = std::move(waiters);
     waiters.clear();
 
+    LuaScheduler* srcSched = LuaScheduler::From(src);
     for (auto& w : ws){
+        LuaScheduler* owner = live(w.owner, w.ownerAlive);
+        if (!owner) continue;
         lua_State* co = (w.kind == Waiter::Kind::Script)
-                      ? sched->GetScriptThread(w.script)
-                      : w.co;
+                      ? owner->GetScriptThread(w.handle)
+                      : owner->GetTaskThread(w.handle);
         if (!co) continue;
         if (!lua_checkstack(co, argc)) continue;
 
-        for (int i = 0; i < argc; ++i) {
-            lua_pushvalue(src, firstArgIdx + i);
-            lua_xmove(src, co, 1);
-        }
+        pushArgs(co, src, owner == srcSched, firstArgIdx, argc);
 
         if (w.kind == Waiter::Kind::Script) {
-            sched->ResumeScriptNextFrame(w.script, argc);
+            owner->ResumeScriptNextFrame(w.handle, argc);
         } else {
-            sched->WakeTaskNextFrame(co, argc);
+            owner->WakeTaskNextFrame(w.handle, argc);
         }
     }
 }
 
-void RTScriptSignal::callListenersDeferred(lua_State* src, int firstArgIdx, int argc){
+void RTScriptSignal::callListeners(lua_State* src, int firstArgIdx, int argc){
     if (!sched || !Lm) return;
 
-    // snapshot active indices; additions won’t run this tick
-    tmpActive.assign(activeIdx.begin(), activeIdx.end());
+    const bool immediate = gBehavior == SignalBehavior::Immediate &&
+                           gImmediateDepth < kMaxImmediateDepth &&
+                           !LuaScheduler::InParallelPhase();
 
-    for (size_t idx : tmpActive){
-        if (idx >= listeners.size()) continue;
+    // Snapshot the listeners: immediate ones may connect, disconnect or fire
+    // this signal again. Nested fires push their own range on top.
+    const size_t first = tmpActive.size();
+    tmpActive.insert(tmpActive.end(), activeIdx.begin(), activeIdx.end());
+    const size_t last = tmpActive.size();
+    const size_t stashFirst = fireStash.size();
+
+    if (immediate) gImmediateDepth++;
+    for (size_t k = first; k < last && !closed; ++k){
+        const size_t idx = tmpActive[k];
         Listener& l = listeners[idx];
         if (!l.connected || l.funcRef == LUA_NOREF) continue;
+        LuaScheduler* owner = live(l.owner, l.ownerAlive);
+        if (!owner) continue;
 
-        const int argcTotal = argc;
-        bool usedReusable = false;
-
-        // Try to use reusable coroutine for non-parallel listeners
-        if (!l.parallel && l.co) {
-            if (!sched->IsTaskActive(l.co)) {
-                if (!lua_checkstack(l.co, 1 + argcTotal)) {
-                    // fall back to ephemeral if stack is tight
-                } else {
-                    lua_getref(Lm, l.funcRef);
-                    lua_xmove(Lm, l.co, 1);
-                    for (int i = 0; i < argcTotal; ++i) {
-                        lua_pushvalue(src, firstArgIdx + i);
-                        lua_xmove(src, l.co, 1);
-                    }
-                    // Pass LUA_NOREF so the scheduler does not unref the reusable thread.
-                    sched->ScheduleTaskNextFrame(l.co, LUA_NOREF, argcTotal);
-                    usedReusable = true;
-                }
-            }
+        // once-listeners stop now but keep their function until the call runs
+        if (l.once) {
+            l.connected = false;
+            l.queued    = true;
+            deactivate(l);
         }
 
-        if (!usedReusable) {
-            // Ephemeral path (parallel listeners or reusable co busy)
-            lua_newthread(Lm);
-            lua_State* co = lua_tothread(Lm, -1);
-            luaL_sandboxthread(co);
-            int tref = lua_ref(Lm, -1); // pops the thread
-
-            if (!lua_checkstack(co, 1 + argcTotal)) {
-                lua_unref(Lm, tref);
-                continue;
-            }
-            lua_getref(Lm, l.funcRef);
-            lua_xmove(Lm, co, 1);
-            for (int i = 0; i < argcTotal; ++i) {
-                lua_pushvalue(src, firstArgIdx + i);
-                lua_xmove(src, co, 1);
-            }
-            sched->ScheduleTaskNextFrame(co, tref, argcTotal);
+        if (immediate && !l.parallel) {
+            owner->DispatchNow(this, (uint32_t)idx, l.id, src, firstArgIdx, argc);
+            continue;   // 'l' may dangle now
         }
 
-        if (l.once) {
-            // safe with tmpActive
-            Disconnect(l.id);
+        // Deferred: one queued call per listener; args are stashed once per
+        // receiving VM and phase, then shared by every call
+        int base = 0;
+        bool found = false;
+        for (size_t s = stashFirst; s < fireStash.size(); ++s) {
+            const Stash& st = fireStash[s];
+            if (st.owner == owner && st.parallel == l.parallel) { base = st.base; found = true; break; }
+        }
+        if (!found) {
+            base = owner->StashArgs(src, firstArgIdx, argc, l.parallel);
+            fireStash.push_back(Stash{ owner, l.parallel, base });
         }
+        owner->QueueDispatch(this, (uint32_t)idx, l.id, base, argc, l.parallel);
     }
+    if (immediate) gImmediateDepth--;
 
-    tmpActive.clear();
+    // Close() from a listener clears both
+    if (tmpActive.size() >= first) tmpActive.resize(first);
+    if (fireStash.size() >= stashFirst) fireStash.resize(stashFirst);
 }
 
 void RTScriptSignal::Fire(lua_State* L, int firstArgIdx, int argc){
     if (closed) return;
-    callListenersDeferred(L, firstArgIdx, argc);
+    callListeners(L, firstArgIdx, argc);
     wakeWaitersWithArgsOnNextFrame(L, firstArgIdx, argc);
 }
 
@@ -202,17 +230,22 @@ void RTScriptSignal::Close(){
     if (closed) return;
     closed = true;
 
+    // queued calls refer to listeners by index; drop them on every VM
+    fireStash.clear();
     for (auto& l : listeners){
-        if (Lm && l.funcRef != LUA_NOREF) {
-            lua_unref(Lm, l.funcRef);
+        LuaScheduler* owner = live(l.owner, l.ownerAlive);
+        if (owner && l.funcRef != LUA_NOREF) {
+            lua_unref(owner->GetMainState(), l.funcRef);
         }
-        if (Lm && l.threadRef != LUA_NOREF) {
-            lua_unref(Lm, l.threadRef);
+        bool seen = false;
+        for (const Stash& st : fireStash) seen = seen || st.owner == owner;
+        if (owner && !seen) {
+            owner->CancelDispatch(this);
+            fireStash.push_back(Stash{ owner, false, 0 });
         }
         l.connected = false;
+        l.queued = false;
         l.funcRef = LUA_NOREF;
-        l.threadRef = LUA_NOREF;
-        l.co = nullptr;
         l.activePos = Listener::npos;
     }
 
@@ -220,5 +253,6 @@ void RTScriptSignal::Close(){
     id2idx.clear();
     activeIdx.clear();
     tmpActive.clear();
+    fireStash.clear();
     // waiters remain suspended by design
 }
@@ -9,7 +9,19 @@
 
 #include "bootstrap/LuaScheduler.h"
 
+// When fired listeners run (workspace.SignalBehavior on the platform we mirror).
+// Deferred: from the scheduler's dispatch queue at the next Step(). Immediate:
+// serial listeners run inside Fire(); parallel ones are always deferred.
+enum class SignalBehavior { Deferred, Immediate };
+
 struct RTScriptSignal : std::enable_shared_from_this<RTScriptSignal> {
+    // Process-wide, set at startup (--signal-behavior)
+    static void           SetBehavior(SignalBehavior b);
+    static SignalBehavior Behavior();
+    // Immediate fires nested deeper than this (a listener firing a signal
+    // whose listener fires ...) are deferred instead
+    static constexpr int  kMaxImmediateDepth = 64;
+
     struct Listener {
         size_t id{0};
         int    funcRef{LUA_NOREF};
@@ -17,16 +29,18 @@ struct RTScriptSignal : std::enable_shared_from_this<RTScriptSignal> {
         bool   parallel{false};
         bool   connected{true};
         size_t activePos{npos};
-        // Reusable coroutine for non-parallel listeners
-        lua_State* co{nullptr};
-        int threadRef{LUA_NOREF};  // registry ref that owns the thread
+        bool   queued{false};      // once-listener fired, call still queued
+        // Scheduler of the VM that connected; refs and threads live there
+        LuaScheduler*       owner{nullptr};
+        std::weak_ptr<void> ownerAlive;   // actor VMs can go away first
         static constexpr size_t npos = std::numeric_limits<size_t>::max();
     };
     struct Waiter {
         enum class Kind { Script, Task };
-        Kind        kind{Kind::Task};
-        BaseScript* script{nullptr};
-        lua_State*  co{nullptr};
+        Kind                 kind{Kind::Task};
+        LuaScheduler::Handle handle{};   // stale once the script stops or the task ends
+        LuaScheduler*        owner{nullptr};
+        std::weak_ptr<void>  ownerAlive;
     };
 
     explicit RTScriptSignal(LuaScheduler* s);
@@ -38,6 +52,10 @@ struct RTScriptSignal : std::enable_shared_from_this<RTScriptSignal> {
     void   Fire(lua_State* L, int firstArgIdx, int argc);
     void   Close();                                 // disconnect all, do not resume waiters
 
+    // Scheduler dispatch: push the callback of a queued call onto 'co'.
+    // False if the listener was disconnected after the fire.
+    bool   PushCallback(lua_State* co, uint32_t listener, size_t id);
+
     // Connection handles:
     void   Disconnect(size_t id);
     bool   IsConnected(size_t id) const;
@@ -52,9 +70,23 @@ private:
     std::vector<Listener> listeners;                 // stable indices
     std::unordered_map<size_t,size_t> id2idx;        // id -> listeners[idx]
     std::vector<size_t> activeIdx;                   // connected listener indices
-    std::vector<size_t> tmpActive;                   // per-fire snapshot
+    std::vector<size_t> tmpActive;                   // per-fire snapshots, stacked by nested fires
     std::vector<Waiter> waiters;
 
+    // Where a fire's args were stashed, per receiving VM and phase; stacked
+    // like tmpActive
+    struct Stash { LuaScheduler* owner; bool parallel; int base; };
+    std::vector<Stash> fireStash;
+
+    // 'owner' if its VM still exists
+    LuaScheduler* live(LuaScheduler* owner, const std::weak_ptr<void>& alive) const {
+        return (owner && (owner == sched || !alive.expired())) ? owner : nullptr;
+    }
+    // Push args [firstArgIdx, +argc) of 'src' onto 'co', copying across VMs
+    static void pushArgs(lua_State* co, lua_State* src, bool sameVM, int firstArgIdx, int argc);
+    // O(1) removal from activeIdx
+    void deactivate(Listener& li);
+
     void wakeWaitersWithArgsOnNextFrame(lua_State* src, int firstArgIdx, int argc);
-    void callListenersDeferred(lua_State* src, int firstArgIdx, int argc);
+    void callListeners(lua_State* src, int firstArgIdx, int argc);
 };
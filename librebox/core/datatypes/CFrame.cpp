@@ -266,12 +266,12 @@ static int cf_new(lua_State* L){
     int n = lua_gettop(L);
     if (n == 0) { lb::push(L, CFrame{}); return 1; }
 
-    if (n == 1 && luaL_testudata(L, 1, Traits<Vector3Game>::MetaName())) {
+    if (n == 1 && lb::is_vector3(L, 1)) {
         const auto* v = lb::check<Vector3Game>(L, 1);
         lb::push(L, CFrame(*v)); return 1;
     }
 
-    if (n == 2 && luaL_testudata(L, 1, Traits<Vector3Game>::MetaName()) && luaL_testudata(L, 2, Traits<Vector3Game>::MetaName())) {
+    if (n == 2 && lb::is_vector3(L, 1) && lb::is_vector3(L, 2)) {
         const auto* pos = lb::check<Vector3Game>(L, 1);
         const auto* lookAt = lb::check<Vector3Game>(L, 2);
         lb::push(L, CFrame::lookAt(*pos, *lookAt)); return 1;
@@ -307,7 +307,7 @@ static int cf_mul(lua_State* L){
     if (luaL_testudata(L, 2, Traits<CFrame>::MetaName())) {
         const auto* B = lb::check<CFrame>(L,2);
         lb::push(L, (*A) * (*B));
-    } else if (luaL_testudata(L, 2, Traits<Vector3Game>::MetaName())) {
+    } else if (lb::is_vector3(L, 2)) {
         const auto* B = lb::check<Vector3Game>(L,2);
         lb::push(L, (*A) * (*B));
     } else {
@@ -483,7 +483,7 @@ static int cf_s_fromMatrix(lua_State* L){
     const auto* x   = lb::check<Vector3Game>(L, 2);
     const auto* y   = lb::check<Vector3Game>(L, 3);
     Vector3Game z;
-    if (lua_gettop(L) >= 4 && luaL_testudata(L, 4, Traits<Vector3Game>::MetaName())) {
+    if (lua_gettop(L) >= 4 && lb::is_vector3(L, 4)) {
         z = *lb::check<Vector3Game>(L, 4);
     } else {
         z = (*x).cross(*y);
@@ -2,6 +2,11 @@
 #include <cstring> // For strcmp
 using namespace lb;
 
+static bool gNativeVector3 = false;
+
+void lb::SetNativeVector3(bool on) { gNativeVector3 = on; }
+bool lb::NativeVector3() { return gNativeVector3; }
+
 // --- Constructor ---
 static int v3_new(lua_State* L){
     float x=(float)luaL_optnumber(L,1,0), y=(float)luaL_optnumber(L,2,0), z=(float)luaL_optnumber(L,3,0);
@@ -78,7 +83,7 @@ static int v3_index(lua_State* L) {
     else {
         // Look for method in metatable
         luaL_getmetatable(L, Traits<Vector3Game>::MetaName());
-        lua_getfield(L, -1, "__index"); // This should be the methods table
+        lua_getfield(L, -1, "__methods"); // __index is this function; methods live here
         lua_getfield(L, -1, key);
         if (lua_isnil(L, -1)) {
             // --- FIX WAS HERE ---
@@ -110,4 +115,63 @@ static const luaL_Reg V3_META[] = {
 lua_CFunction Traits<Vector3Game>::Ctor() { return v3_new; }
 const luaL_Reg* Traits<Vector3Game>::Methods() { return V3_METHODS; }
 const luaL_Reg* Traits<Vector3Game>::MetaMethods() { return V3_META; }
-const luaL_Reg* Traits<Vector3Game>::Statics() { return nullptr; }
\ No newline at end of file
+const luaL_Reg* Traits<Vector3Game>::Statics() { return nullptr; }
+
+// ---------------- Native vector mode ----------------
+// X/Y/Z reads and + - * / never reach these; the VM handles them inline.
+
+static int vec_lerp(lua_State* L) {
+    const auto* a = check<Vector3Game>(L, 1);
+    const auto* b = check<Vector3Game>(L, 2);
+    float alpha = (float)luaL_checknumber(L, 3);
+    push(L, a->lerp(*b, alpha));
+    return 1;
+}
+
+static lua_CFunction vec_method(const char* key) {
+    switch (key[0]) {
+    case 'D': return strcmp(key, "Dot") == 0   ? v3_dot   : nullptr;
+    case 'C': return strcmp(key, "Cross") == 0 ? v3_cross : nullptr;
+    case 'L': return strcmp(key, "Lerp") == 0  ? vec_lerp : nullptr;
+    default:  return nullptr;
+    }
+}
+
+static int vec_index(lua_State* L) {
+    const auto* v = check<Vector3Game>(L, 1);
+    const char* key = luaL_checkstring(L, 2);
+
+    if (strcmp(key, "Magnitude") == 0) lua_pushnumber(L, v->magnitude());
+    else if (strcmp(key, "Unit") == 0) push(L, v->normalized());
+    else if (lua_CFunction fn = vec_method(key)) lua_pushcfunction(L, fn, key);
+    else luaL_error(L, "invalid member '%s' for Vector3", key);
+    return 1;
+}
+
+static int vec_namecall(lua_State* L) {
+    const char* name = lua_namecallatom(L, nullptr);
+    if (!name) luaL_error(L, "namecall without a method name");
+    lua_CFunction fn = vec_method(name);
+    if (!fn) luaL_error(L, "invalid member '%s' for Vector3", name);
+    return fn(L);
+}
+
+static int vec_tostring(lua_State* L) {
+    const auto* v = check<Vector3Game>(L, 1);
+    lua_pushfstring(L, "%f, %f, %f", v->x, v->y, v->z);
+    return 1;
+}
+
+void lb::register_native_vector3(lua_State* L) {
+    // replaces the vector library's read-only metatable (which only knows x/y/z)
+    lua_createtable(L, 0, 3);
+    lua_pushcfunction(L, vec_index, "__index");       lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, vec_namecall, "__namecall"); lua_setfield(L, -2, "__namecall");
+    lua_pushcfunction(L, vec_tostring, "__tostring"); lua_setfield(L, -2, "__tostring");
+    lua_setreadonly(L, -1, true);
+
+    lua_pushvector(L, 0.0f, 0.0f, 0.0f);
+    lua_pushvalue(L, -2);
+    lua_setmetatable(L, -2);
+    lua_pop(L, 2);
+}
@@ -48,4 +48,34 @@ template<> struct Traits<Vector3Game> {
     static const luaL_Reg* MetaMethods();
     static const luaL_Reg* Statics();
 };
+
+static_assert(sizeof(Vector3Game) == 3 * sizeof(float), "Vector3Game must alias a Luau vector");
+
+// Opt-in: Vector3 values are Luau's native 'vector' type (unboxed, no GC
+// allocation, VM fast paths for X/Y/Z and arithmetic) instead of userdata.
+// Must be chosen before register_type<Vector3Game> runs on any state.
+void SetNativeVector3(bool on);
+bool NativeVector3();
+
+// True for a Vector3 in either representation
+inline bool is_vector3(lua_State* L, int idx) {
+    return lua_isvector(L, idx) || luaL_testudata(L, idx, Traits<Vector3Game>::MetaName());
+}
+
+// Accept both representations; the pointer is valid while the value stays on the stack
+template<>
+inline const Vector3Game* check<Vector3Game>(lua_State* L, int idx) {
+    if (const float* v = lua_tovector(L, idx)) return reinterpret_cast<const Vector3Game*>(v);
+    return static_cast<const Vector3Game*>(luaL_checkudata(L, idx, Traits<Vector3Game>::MetaName()));
+}
+
+template<>
+inline void push<Vector3Game>(lua_State* L, const Vector3Game& v) {
+    if (NativeVector3()) { lua_pushvector(L, v.x, v.y, v.z); return; }
+    *new_ud<Vector3Game>(L) = v;
+}
+
+// Installs the metatable for native vectors (Magnitude, Unit, Dot, Cross, Lerp).
+// Call after register_type<Vector3Game> when NativeVector3() is on.
+void register_native_vector3(lua_State* L);
 } // namespace lb